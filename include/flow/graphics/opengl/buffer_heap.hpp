@@ -0,0 +1,210 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "../../core/assertion.hpp"
+#include "../../utility/buddy_partitioner.hpp"
+#include "../../utility/concepts.hpp"
+#include "buffer.hpp"
+#include "fence.hpp"
+
+namespace flow::gl {
+
+template<concepts::trivially_copyable T>
+struct buffer_allocation
+{
+    using value_type = T;
+
+    std::span<value_type> values;
+    std::size_t offset; // in bytes, from the start of the heap buffer
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return values.data() != nullptr;
+    }
+};
+
+// one large persistently mapped buffer that is sub-allocated with a buddy_partitioner
+// freed allocations are only recycled once the gpu commands that were
+// submitted before the next call to retire have completed
+class buffer_heap
+{
+public:
+    using buffer_type = gl::buffer<std::byte>;
+    using size_type = typename buffer_type::size_type;
+    using offset_type = typename buffer_type::offset_type;
+    using index_type = typename buffer_type::index_type;
+    using partitioner_type = buddy_partitioner<std::size_t, size_type>;
+
+    // satisfies the offset alignment required for binding ranges
+    // of uniform and shader storage buffers by common implementations
+    static constexpr size_type default_block_size = 256;
+
+private:
+    struct retired_frees
+    {
+        gl::fence fence;
+        std::vector<size_type> offsets;
+    };
+
+public:
+    buffer_heap() noexcept = default;
+
+    // the buffer is created and mapped before anything of the heap changes, so a failed
+    // create leaves the heap as it was, a successful one drops the previous buffer and allocations
+    bool create(size_type capacity, size_type block_size = default_block_size)
+    {
+        FLOW_ASSERT(block_size > 0, "invalid block size");
+
+        const size_type block_count = std::bit_floor(capacity / block_size);
+        buffer_type buffer{};
+
+        if (block_count == 0 || !buffer.create())
+        {
+            return false;
+        }
+
+        using sf = buffer_storage_flags;
+        using mf = buffer_map_flags;
+
+        const size_type size = block_count * block_size;
+
+        // a failed storage call is caught by the map that follows it
+        buffer.storage(size, sf::dynamic_storage | sf::map_write | sf::map_persistent | sf::map_coherent);
+        const std::span<std::byte> mapping = buffer.map(size, 0, mf::write | mf::persistent | mf::coherent);
+
+        if (mapping.empty())
+        {
+            return false;
+        }
+
+        m_buffer = std::move(buffer);
+        m_mapping = mapping;
+        m_partitioner.create(block_count, block_size);
+        m_pending_frees.clear();
+        m_retired_frees.clear();
+
+        return true;
+    }
+
+    template<concepts::trivially_copyable U>
+    [[nodiscard]] buffer_allocation<U> alloc(size_type count)
+    {
+        FLOW_ASSERT(m_partitioner.block_size() % alignof(U) == 0, "block size is not a multiple of the type alignment");
+
+        auto offset = m_partitioner.alloc(count * sizeof(U));
+
+        if (!offset)
+        {
+            reclaim();
+            offset = m_partitioner.alloc(count * sizeof(U));
+        }
+
+        if (!offset)
+        {
+            return { .values = {}, .offset = 0 };
+        }
+
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        auto* ptr = reinterpret_cast<U*>(m_mapping.data() + *offset);
+
+        return { .values = std::span(ptr, count), .offset = *offset };
+    }
+
+    // the allocation is not reused before the fence of the next retire call is signaled
+    template<concepts::trivially_copyable U>
+    void free(const buffer_allocation<U>& allocation)
+    {
+        if (allocation)
+        {
+            m_pending_frees.push_back(allocation.offset);
+        }
+    }
+
+    // call after submitting the commands that might still read
+    // the allocations that were freed since the last call
+    void retire()
+    {
+        if (m_pending_frees.empty())
+        {
+            return;
+        }
+
+        retired_frees& retired = m_retired_frees.emplace_back();
+        retired.fence.lock();
+        retired.offsets.swap(m_pending_frees);
+    }
+
+    // recycles the retired allocations whose fences were signaled, without blocking
+    void reclaim()
+    {
+        while (!m_retired_frees.empty() && m_retired_frees.front().fence.signaled())
+        {
+            release_front();
+        }
+    }
+
+    // waits for all retired allocations to be safe to recycle
+    void reclaim_all()
+    {
+        while (!m_retired_frees.empty())
+        {
+            m_retired_frees.front().fence.wait();
+            release_front();
+        }
+    }
+
+    template<concepts::trivially_copyable U>
+    void bind_range(buffer_target target, index_type index, const buffer_allocation<U>& allocation) const noexcept
+    {
+        m_buffer.bind_range(target,
+                            index,
+                            allocation.values.size_bytes(),
+                            static_cast<offset_type>(allocation.offset));
+    }
+
+    [[nodiscard]] constexpr const buffer_type& buffer() const noexcept
+    {
+        return m_buffer;
+    }
+
+    [[nodiscard]] constexpr const partitioner_type& partitioner() const noexcept
+    {
+        return m_partitioner;
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const noexcept
+    {
+        return m_partitioner.capacity();
+    }
+
+    [[nodiscard]] constexpr size_type block_size() const noexcept
+    {
+        return m_partitioner.block_size();
+    }
+
+private:
+    void release_front()
+    {
+        for (const size_type offset : m_retired_frees.front().offsets)
+        {
+            m_partitioner.free(offset);
+        }
+
+        m_retired_frees.pop_front();
+    }
+
+private:
+    buffer_type m_buffer{};
+    std::span<std::byte> m_mapping{};
+    partitioner_type m_partitioner{};
+    std::vector<size_type> m_pending_frees{};
+    std::deque<retired_frees> m_retired_frees{};
+};
+
+} // namespace flow::gl
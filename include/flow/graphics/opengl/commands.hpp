@@ -7,6 +7,7 @@
 
 #include <glad/gl.h>
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
 #include "enum_types.hpp"
@@ -54,6 +55,18 @@ inline void multi_draw_arrays(primitive_type primitive, Rc&& counts, Ro&& offset
                       static_cast<GLsizei>(std::min(std::ranges::size(counts), std::ranges::size(offsets))));
 }
 
+inline void dispatch_compute(glm::uvec3 group_count) noexcept
+{
+    glDispatchCompute(static_cast<GLuint>(group_count.x),
+                      static_cast<GLuint>(group_count.y),
+                      static_cast<GLuint>(group_count.z));
+}
+
+inline void memory_barrier(memory_barrier_flags flags) noexcept
+{
+    glMemoryBarrier(static_cast<GLbitfield>(flags));
+}
+
 inline void clear(clear_target_flags flags = clear_target_flags::color) noexcept
 {
     glClear(static_cast<GLbitfield>(flags));
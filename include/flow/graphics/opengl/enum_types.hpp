@@ -74,6 +74,33 @@ enum class clear_target_flags : GLbitfield
     return static_cast<clear_target_flags>(static_cast<GLbitfield>(lhs) | static_cast<GLbitfield>(rhs));
 }
 
+enum class memory_barrier_flags : GLbitfield
+{
+    vertex_attrib_array = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+    element_array = GL_ELEMENT_ARRAY_BARRIER_BIT,
+    uniform = GL_UNIFORM_BARRIER_BIT,
+    texture_fetch = GL_TEXTURE_FETCH_BARRIER_BIT,
+    shader_image_access = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+    command = GL_COMMAND_BARRIER_BIT,
+    pixel_buffer = GL_PIXEL_BUFFER_BARRIER_BIT,
+    texture_update = GL_TEXTURE_UPDATE_BARRIER_BIT,
+    buffer_update = GL_BUFFER_UPDATE_BARRIER_BIT,
+    shader_storage = GL_SHADER_STORAGE_BARRIER_BIT,
+    all = GL_ALL_BARRIER_BITS,
+};
+
+[[nodiscard]] constexpr memory_barrier_flags operator|(memory_barrier_flags lhs, memory_barrier_flags rhs) noexcept
+{
+    return static_cast<memory_barrier_flags>(static_cast<GLbitfield>(lhs) | static_cast<GLbitfield>(rhs));
+}
+
+enum class image_access : GLenum
+{
+    read_only = GL_READ_ONLY,
+    write_only = GL_WRITE_ONLY,
+    read_write = GL_READ_WRITE,
+};
+
 template<concepts::any_of<GLfloat,
                           GLdouble,
                           GLbyte,
@@ -42,6 +42,18 @@ public:
         while (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED);
     }
 
+    [[nodiscard]] bool signaled() const noexcept
+    {
+        if (!m_handle.get())
+        {
+            return true;
+        }
+
+        const GLenum result = glClientWaitSync(m_handle.get(), GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
 private:
     handle_type m_handle{};
 };
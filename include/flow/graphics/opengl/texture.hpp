@@ -42,7 +42,13 @@ enum class texture_format : GLenum
     rgba12 = GL_RGBA12,
     rgba16 = GL_RGBA16,
     srgb8 = GL_SRGB8,
-    srgb8a8 = GL_SRGB8_ALPHA8
+    srgb8a8 = GL_SRGB8_ALPHA8,
+    r16f = GL_R16F,
+    r32f = GL_R32F,
+    rg16f = GL_RG16F,
+    rg32f = GL_RG32F,
+    rgba16f = GL_RGBA16F,
+    rgba32f = GL_RGBA32F
 };
 
 enum class texture_wrap_mode : GLint
@@ -290,6 +296,31 @@ public:
         glBindTexture(static_cast<GLenum>(Type), m_handle.get());
     }
 
+    // binds a level of the texture to an image unit, for image load and store in shaders
+    void bind_image(GLuint unit, image_access access, texture_format format, size_type mipmap_level = 0) const noexcept
+    {
+        glBindImageTexture(unit,
+                           m_handle.get(),
+                           static_cast<GLint>(mipmap_level),
+                           static_cast<GLboolean>(Type == texture_type::texture3D || Type == texture_type::texture1D_array
+                                                  || Type == texture_type::texture2D_array),
+                           0,
+                           static_cast<GLenum>(access),
+                           static_cast<GLenum>(format));
+    }
+
+    // reads a whole level of the texture back into values
+    template<typename T, std::size_t Extent>
+    void get_image(std::span<T, Extent> values, size_type mipmap_level, pixel_format format, type_value type) const noexcept
+    {
+        glGetTextureImage(m_handle.get(),
+                          static_cast<GLint>(mipmap_level),
+                          static_cast<GLenum>(format),
+                          static_cast<GLenum>(type),
+                          static_cast<GLsizei>(values.size_bytes()),
+                          values.data());
+    }
+
     [[nodiscard]] constexpr id_type id() const noexcept
     {
         return m_handle.get();
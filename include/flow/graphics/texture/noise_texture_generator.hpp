@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include <glad/gl.h>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "../../core/logger.hpp"
+#include "../../utility/noise.hpp"
+#include "../opengl/buffer.hpp"
+#include "../opengl/commands.hpp"
+#include "../opengl/enum_types.hpp"
+#include "../opengl/shader.hpp"
+#include "../opengl/texture.hpp"
+
+namespace flow {
+
+// evaluates the 2d noise of an open_simplex instance into r32f textures with a compute shader
+// the permutation and gradient tables of the instance are uploaded to shader storage, and the
+// kernel repeats the operations of open_simplex<2, float> in the same order, so the values are
+// equal to the cpu ones up to rounding
+class noise_texture_generator
+{
+private:
+    static constexpr std::string_view compute_shader_source = R"(
+    #version 460
+
+    layout(local_size_x = 8, local_size_y = 8) in;
+
+    layout(std430, binding = 0) readonly buffer permutation_buffer
+    {
+        int permutations[];
+    };
+
+    layout(std430, binding = 1) readonly buffer gradient_buffer
+    {
+        vec2 gradients[];
+    };
+
+    layout(r32f, binding = 0) uniform writeonly image2D u_values;
+
+    layout(location = 0) uniform vec2 u_origin;
+    layout(location = 1) uniform vec2 u_step;
+    layout(location = 2) uniform uvec2 u_size;
+    layout(location = 3) uniform int u_mask;
+
+    const ivec2 lattice_points[4] = ivec2[4](ivec2(1, 0), ivec2(0, 0), ivec2(1, 1), ivec2(0, 1));
+
+    void main()
+    {
+        uvec2 texel = gl_GlobalInvocationID.xy;
+
+        if (any(greaterThanEqual(texel, u_size)))
+        {
+            return;
+        }
+
+        precise vec2 point = u_origin + vec2(texel) * u_step;
+
+        precise float s = (point.x + point.y) * 0.366025403784439;
+        point += s;
+
+        vec2 point_base = floor(point);
+        precise vec2 offset = point - point_base;
+
+        int index = offset.y - offset.x >= 0.0 ? 1 : 0;
+
+        precise float t = (offset.x + offset.y) * -0.211324865405187;
+        offset += t;
+
+        ivec2 cell = ivec2(point_base);
+        precise float value = 0.0;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ivec2 lattice_point = lattice_points[index + i];
+
+            precise float ssv = float(lattice_point.x + lattice_point.y) * -0.211324865405187;
+            precise vec2 d = offset - (vec2(lattice_point) + ssv);
+
+            precise float attenuation = 0.5 - (d.x * d.x + d.y * d.y);
+
+            if (attenuation <= 0.0)
+            {
+                continue;
+            }
+
+            ivec2 point_mask = (cell + lattice_point) & u_mask;
+            vec2 gradient = gradients[permutations[point_mask.x] ^ point_mask.y];
+
+            precise float extrapolation = gradient.x * d.x + gradient.y * d.y;
+
+            attenuation *= attenuation;
+            value += attenuation * attenuation * extrapolation;
+        }
+
+        imageStore(u_values, ivec2(texel), vec4(value));
+    }
+    )";
+
+    static constexpr GLuint local_size = 8;
+
+public:
+    constexpr noise_texture_generator() noexcept = default;
+
+    // compiles the kernel and uploads the tables of noise, the gradients are converted to float
+    template<typename T, std::size_t PermN>
+    bool create(const open_simplex<2, T, PermN>& noise)
+    {
+        gl::shader compute_shader;
+
+        if (!(compute_shader.create(gl::shader_type::compute)
+            && compute_shader.from_string(compute_shader_source)
+            && compute_shader.compile()))
+        {
+            FLOW_LOG_ERROR("failed to create compute shader: {}", compute_shader.get_info_log());
+            return false;
+        }
+
+        if (!(m_program.create() && m_program.link(compute_shader)))
+        {
+            FLOW_LOG_ERROR("failed to link shaders: {}", m_program.get_info_log());
+            return false;
+        }
+
+        if (!(m_permutations.create() && m_gradients.create()))
+        {
+            FLOW_LOG_ERROR("failed to create shader storage");
+            return false;
+        }
+
+        // std430 has no 16 bit integers
+        const std::vector<GLint> permutations(noise.permutations().begin(), noise.permutations().end());
+        std::vector<glm::vec2> gradients{};
+        gradients.reserve(noise.gradient_permutations().size());
+
+        for (const auto& gradient : noise.gradient_permutations())
+        {
+            gradients.emplace_back(static_cast<float>(gradient.x), static_cast<float>(gradient.y));
+        }
+
+        m_permutations.storage(permutations, gl::buffer_storage_flags::none);
+        m_gradients.storage(gradients, gl::buffer_storage_flags::none);
+        m_mask = static_cast<GLint>(PermN - 1);
+
+        return true;
+    }
+
+    // texture[y][x] = noise(origin.x + x * step.x, origin.y + y * step.y), the texture must have
+    // r32f storage of at least width * height texels in its first level
+    void fill(const gl::texture2D& texture, glm::vec2 origin, glm::vec2 step, std::size_t width, std::size_t height) const
+    {
+        m_program.use();
+        m_program.set_uniform(0, origin);
+        m_program.set_uniform(1, step);
+        m_program.set_uniform(2, glm::uvec2(static_cast<GLuint>(width), static_cast<GLuint>(height)));
+        m_program.set_uniform(3, m_mask);
+
+        m_permutations.bind_base(gl::buffer_target::shader_storage, 0);
+        m_gradients.bind_base(gl::buffer_target::shader_storage, 1);
+        texture.bind_image(0, gl::image_access::write_only, gl::texture_format::r32f);
+
+        gl::dispatch_compute({ (static_cast<GLuint>(width) + local_size - 1) / local_size,
+                               (static_cast<GLuint>(height) + local_size - 1) / local_size,
+                               1 });
+
+        // the texture is sampled or read back after this
+        gl::memory_barrier(gl::memory_barrier_flags::texture_fetch
+                           | gl::memory_barrier_flags::shader_image_access
+                           | gl::memory_barrier_flags::texture_update);
+    }
+
+private:
+    gl::shader_program m_program{};
+    gl::buffer<GLint> m_permutations{};
+    gl::buffer<glm::vec2> m_gradients{};
+    GLint m_mask{};
+};
+
+} // namespace flow
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace flow {
+
+namespace detail {
+
+    inline constexpr std::size_t max_aggregate_member_count = 16;
+
+    // converts to anything but the aggregate itself, which would turn a single initializer into a copy
+    template<typename AggregateT>
+    struct any_member
+    {
+        template<typename T>
+            requires(!std::same_as<std::remove_cvref_t<T>, AggregateT>)
+        operator T() const; // NOLINT(*-explicit-constructor)
+    };
+
+    // the largest number of initializers the aggregate accepts, which is its number of members
+    // as long as it has no base classes and no c array members (whose elements would be counted)
+    // counts up to max_aggregate_member_count + 1, so that larger aggregates can be told apart
+    template<typename T, typename... Args>
+    [[nodiscard]] consteval std::size_t aggregate_member_count() noexcept
+    {
+        if constexpr (sizeof...(Args) <= max_aggregate_member_count
+                      && requires { T{ std::declval<Args>()..., std::declval<any_member<T>>() }; })
+        {
+            return aggregate_member_count<T, Args..., any_member<T>>();
+        }
+        else
+        {
+            return sizeof...(Args);
+        }
+    }
+
+    // the same count, with every initializer in its own braces, so that c array members are
+    // counted once instead of once per element
+    template<typename T, typename... Args>
+    [[nodiscard]] consteval std::size_t braced_aggregate_member_count() noexcept
+    {
+        if constexpr (sizeof...(Args) <= max_aggregate_member_count
+                      && requires { T{ { std::declval<Args>() }..., { std::declval<any_member<T>>() } }; })
+        {
+            return braced_aggregate_member_count<T, Args..., any_member<T>>();
+        }
+        else
+        {
+            return sizeof...(Args);
+        }
+    }
+
+    // aggregates whose members tie_members can bind: no c array members, and not too many members
+    template<typename T>
+    concept decomposable_aggregate = std::is_aggregate_v<T>
+                                  && !std::is_array_v<T>
+                                  && !std::is_union_v<T>
+                                  && aggregate_member_count<T>() <= max_aggregate_member_count
+                                  && aggregate_member_count<T>() == braced_aggregate_member_count<T>();
+
+    // returns a tuple of references to the members of the aggregate
+    template<std::size_t Count, typename T>
+    [[nodiscard]] constexpr auto tie_members(T& value) noexcept
+    {
+        if constexpr (Count == 0)
+        {
+            return std::tuple<>{};
+        }
+        else if constexpr (Count == 1)
+        {
+            auto& [m0] = value;
+            return std::tie(m0);
+        }
+        else if constexpr (Count == 2)
+        {
+            auto& [m0, m1] = value;
+            return std::tie(m0, m1);
+        }
+        else if constexpr (Count == 3)
+        {
+            auto& [m0, m1, m2] = value;
+            return std::tie(m0, m1, m2);
+        }
+        else if constexpr (Count == 4)
+        {
+            auto& [m0, m1, m2, m3] = value;
+            return std::tie(m0, m1, m2, m3);
+        }
+        else if constexpr (Count == 5)
+        {
+            auto& [m0, m1, m2, m3, m4] = value;
+            return std::tie(m0, m1, m2, m3, m4);
+        }
+        else if constexpr (Count == 6)
+        {
+            auto& [m0, m1, m2, m3, m4, m5] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5);
+        }
+        else if constexpr (Count == 7)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6);
+        }
+        else if constexpr (Count == 8)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7);
+        }
+        else if constexpr (Count == 9)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8);
+        }
+        else if constexpr (Count == 10)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9);
+        }
+        else if constexpr (Count == 11)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+        }
+        else if constexpr (Count == 12)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+        }
+        else if constexpr (Count == 13)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+        }
+        else if constexpr (Count == 14)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13);
+        }
+        else if constexpr (Count == 15)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14);
+        }
+        else if constexpr (Count == 16)
+        {
+            auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15] = value;
+            return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15);
+        }
+    }
+
+} // namespace detail
+
+template<typename T>
+inline constexpr std::size_t aggregate_member_count_v = detail::aggregate_member_count<T>();
+
+} // namespace flow
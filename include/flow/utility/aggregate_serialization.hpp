@@ -0,0 +1,181 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "aggregate_members.hpp"
+#include "concepts.hpp"
+#include "istream_view.hpp"
+#include "ostream_view.hpp"
+#include "serialization.hpp"
+
+namespace flow {
+
+namespace detail {
+
+    // a run of adjacent trivially copyable members, which is read or written with a single call
+    template<typename ByteT>
+    struct member_run
+    {
+        ByteT* data{ nullptr };
+        std::size_t size{};
+    };
+
+    template<typename ByteT, typename StreamT>
+    void flush_member_run(StreamT& stream, member_run<ByteT>& run)
+    {
+        if (run.size == 0)
+        {
+            return;
+        }
+
+        if constexpr (std::is_const_v<ByteT>)
+        {
+            stream.write(std::span(run.data, run.size));
+        }
+        else
+        {
+            stream.read(std::span(run.data, run.size));
+        }
+
+        run.size = 0;
+    }
+
+    template<typename ByteT, typename T>
+    void extend_member_run(member_run<ByteT>& run, T& member, auto& stream)
+    {
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        auto* data = reinterpret_cast<ByteT*>(std::addressof(member));
+
+        if (run.size > 0 && run.data + run.size == data)
+        {
+            run.size += sizeof(T);
+            return;
+        }
+
+        flush_member_run(stream, run);
+        run = { data, sizeof(T) };
+    }
+
+} // namespace detail
+
+// opt-in serializer for aggregates, that serializes the members one by one,
+// but writes runs of adjacent trivially copyable members with a single call
+// the members are serialized with their serializer specialization if they have one,
+// or as aggregates themselves otherwise, e.g.
+//
+// template<>
+// struct flow::serializer<level_info> : flow::aggregate_serializer<level_info>
+// {};
+template<typename T>
+    requires std::is_aggregate_v<T>
+struct aggregate_serializer
+{
+    static_assert(detail::decomposable_aggregate<T>,
+                  "too many members or c array members for aggregate serialization");
+
+    void operator()(ostream_view out, const T& value) const
+    {
+        detail::member_run<const std::byte> run{};
+
+        std::apply([&](const auto&... members) { (write_member(out, run, members), ...); },
+                   detail::tie_members<aggregate_member_count_v<T>>(value));
+
+        detail::flush_member_run(out, run);
+    }
+
+private:
+    template<typename MemberT>
+    static void write_member(ostream_view& out, detail::member_run<const std::byte>& run, const MemberT& member)
+    {
+        // with a foreign byte order, the trivially copyable members are swapped one by one, nested
+        // aggregates keep the layout they have in memory, padding included, in both byte orders
+        if constexpr (concepts::trivially_copyable<MemberT> && sizeof(MemberT) > 1)
+        {
+            if (!out.is_native_byte_order())
+            {
+                detail::flush_member_run(out, run);
+                out.write(member);
+                return;
+            }
+        }
+
+        if constexpr (concepts::trivially_copyable<MemberT>)
+        {
+            detail::extend_member_run(run, member, out);
+        }
+        else
+        {
+            detail::flush_member_run(out, run);
+
+            if constexpr (concepts::serializer<serializer<MemberT>, MemberT>)
+            {
+                out.serialize(member);
+            }
+            else
+            {
+                out.serialize(member, aggregate_serializer<MemberT>{});
+            }
+        }
+    }
+};
+
+// opt-in deserializer matching aggregate_serializer
+template<typename T>
+    requires std::is_aggregate_v<T>
+struct aggregate_deserializer
+{
+    static_assert(detail::decomposable_aggregate<T>,
+                  "too many members or c array members for aggregate deserialization");
+
+    void operator()(istream_view in, T& value) const
+    {
+        detail::member_run<std::byte> run{};
+
+        std::apply([&](auto&... members) { (read_member(in, run, members), ...); },
+                   detail::tie_members<aggregate_member_count_v<T>>(value));
+
+        detail::flush_member_run(in, run);
+    }
+
+private:
+    template<typename MemberT>
+    static void read_member(istream_view& in, detail::member_run<std::byte>& run, MemberT& member)
+    {
+        // with a foreign byte order, the trivially copyable members are swapped one by one, nested
+        // aggregates keep the layout they have in memory, padding included, in both byte orders
+        if constexpr (concepts::trivially_copyable<MemberT> && sizeof(MemberT) > 1)
+        {
+            if (!in.is_native_byte_order())
+            {
+                detail::flush_member_run(in, run);
+                in.read(member);
+                return;
+            }
+        }
+
+        if constexpr (concepts::trivially_copyable<MemberT>)
+        {
+            detail::extend_member_run(run, member, in);
+        }
+        else
+        {
+            detail::flush_member_run(in, run);
+
+            if constexpr (concepts::deserializer<deserializer<MemberT>, MemberT>)
+            {
+                in.deserialize(member);
+            }
+            else
+            {
+                in.deserialize(member, aggregate_deserializer<MemberT>{});
+            }
+        }
+    }
+};
+
+} // namespace flow
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "concepts.hpp"
+#include "istream_view.hpp"
+#include "sliding_window.hpp"
+
+namespace flow {
+
+enum class sliding_load_status : std::uint8_t
+{
+    hit,    // the window was served from the prefetched values
+    miss,   // the window was read synchronously
+    failed, // the stream failed
+};
+
+// read-only sliding_stream_buffer that, after every load, reads the next window
+// in the direction of the last forward/backward/set_begin call on a background thread,
+// so a load that follows the same movement only copies or swaps in the prefetched values
+// the stream is owned by the buffer between create and destruction: it is only
+// ever accessed by one thread at a time, but must not be used by anything else
+template<concepts::trivially_copyable T, std::unsigned_integral SizeT = std::size_t>
+class async_sliding_stream_buffer
+{
+public:
+    using value_type = T;
+    using size_type = SizeT;
+
+public:
+    async_sliding_stream_buffer() noexcept = default;
+
+    async_sliding_stream_buffer(istream_view in,
+                                size_type stream_start_position,
+                                size_type element_count,
+                                size_type buffer_element_count)
+    {
+        create(in, stream_start_position, element_count, buffer_element_count);
+    }
+
+    async_sliding_stream_buffer(istream_view in,
+                                size_type stream_start_position,
+                                size_type element_count,
+                                size_type buffer_element_count,
+                                size_type buffer_begin_index)
+    {
+        create(in, stream_start_position, element_count, buffer_element_count, buffer_begin_index);
+    }
+
+    async_sliding_stream_buffer(const async_sliding_stream_buffer& other) = delete;
+    async_sliding_stream_buffer& operator=(const async_sliding_stream_buffer& other) = delete;
+
+    ~async_sliding_stream_buffer()
+    {
+        wait_idle();
+    }
+
+    void create(istream_view in,
+                size_type stream_start_position,
+                size_type element_count,
+                size_type buffer_element_count)
+    {
+        create(in,
+               stream_start_position,
+               sliding_window(size_type{ 0 }, element_count, buffer_element_count));
+    }
+
+    void create(istream_view in,
+                size_type stream_start_position,
+                size_type element_count,
+                size_type buffer_element_count,
+                size_type buffer_begin_index)
+    {
+        create(in,
+               stream_start_position,
+               sliding_window(size_type{ 0 }, element_count, buffer_element_count, buffer_begin_index));
+    }
+
+    size_type forward(size_type count) noexcept
+    {
+        return record_step(m_sliding_window.forward(count), travel_direction::forward);
+    }
+
+    size_type backward(size_type count) noexcept
+    {
+        return record_step(m_sliding_window.backward(count), travel_direction::backward);
+    }
+
+    void set_begin(size_type position) noexcept
+    {
+        const size_type previous = begin();
+        m_sliding_window.seek(position);
+
+        if (begin() > previous)
+        {
+            record_step(begin() - previous, travel_direction::forward);
+        }
+        else if (begin() < previous)
+        {
+            record_step(previous - begin(), travel_direction::backward);
+        }
+    }
+
+    [[nodiscard]] constexpr size_type begin() const noexcept
+    {
+        return m_sliding_window.begin();
+    }
+
+    [[nodiscard]] constexpr size_type end() const noexcept
+    {
+        return m_sliding_window.end();
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return m_sliding_window.size();
+    }
+
+    [[nodiscard]] constexpr size_type bounds_begin() const noexcept
+    {
+        return m_sliding_window.bounds_begin();
+    }
+
+    [[nodiscard]] constexpr size_type bounds_end() const noexcept
+    {
+        return m_sliding_window.bounds_end();
+    }
+
+    [[nodiscard]] constexpr size_type bounds_size() const noexcept
+    {
+        return m_sliding_window.bounds_size();
+    }
+
+    [[nodiscard]] constexpr size_type stream_begin() const noexcept
+    {
+        return m_stream_start_position + begin() * sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type stream_end() const noexcept
+    {
+        return m_stream_start_position + end() * sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type stream_size() const noexcept
+    {
+        return size() * sizeof(value_type);
+    }
+
+    // the values of the window that was last loaded
+    [[nodiscard]] constexpr std::span<const value_type> values() const noexcept
+    {
+        return m_front;
+    }
+
+    // waits at most for the prefetch that is in flight, then starts the next one
+    sliding_load_status load()
+    {
+        wait_idle();
+
+        sliding_load_status status = sliding_load_status::miss;
+
+        if (m_back_size > 0 && begin() >= m_back_begin && end() <= m_back_begin + m_back_size)
+        {
+            if (begin() == m_back_begin && m_back_size == size())
+            {
+                m_front.swap(m_back);
+            }
+            else
+            {
+                std::memcpy(m_front.data(), m_back.data() + (begin() - m_back_begin), size() * sizeof(value_type));
+            }
+
+            status = sliding_load_status::hit;
+        }
+        else if (!read(m_front, begin(), size()))
+        {
+            status = sliding_load_status::failed;
+        }
+
+        m_back_size = 0;
+        prefetch();
+
+        return status;
+    }
+
+private:
+    enum class travel_direction : std::uint8_t
+    {
+        none,
+        forward,
+        backward,
+    };
+
+    void create(istream_view in, size_type stream_start_position, const sliding_window<size_type>& window)
+    {
+        wait_idle();
+
+        m_in = in;
+        m_stream_start_position = stream_start_position;
+        m_sliding_window = window;
+        m_front.resize(size());
+        m_back.resize(size());
+        m_back_size = 0;
+        m_direction = travel_direction::none;
+        m_step = 0;
+
+        if (!m_worker.joinable())
+        {
+            m_worker = std::jthread([this](std::stop_token stop_token) { run(stop_token); });
+        }
+    }
+
+    size_type record_step(size_type step, travel_direction direction) noexcept
+    {
+        if (step > 0)
+        {
+            m_step = step;
+            m_direction = direction;
+        }
+
+        return step;
+    }
+
+    // expects no prefetch to be in flight
+    void prefetch()
+    {
+        size_type next_begin = begin();
+
+        if (m_direction == travel_direction::forward)
+        {
+            next_begin = std::min(begin() + m_step, bounds_end() - size());
+        }
+        else if (m_direction == travel_direction::backward)
+        {
+            next_begin = begin() - std::min(m_step, begin() - bounds_begin());
+        }
+
+        if (next_begin == begin())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_request_begin = next_begin;
+            m_request_size = size();
+            m_request_pending = true;
+        }
+
+        m_condition.notify_all();
+    }
+
+    void wait_idle()
+    {
+        std::unique_lock lock{ m_mutex };
+        m_condition.wait(lock, [this] { return !m_request_pending && !m_busy; });
+    }
+
+    void run(std::stop_token stop_token)
+    {
+        while (true)
+        {
+            size_type request_begin{};
+            size_type request_size{};
+
+            {
+                std::unique_lock lock{ m_mutex };
+
+                if (!m_condition.wait(lock, stop_token, [this] { return m_request_pending; }))
+                {
+                    return;
+                }
+
+                request_begin = m_request_begin;
+                request_size = m_request_size;
+                m_request_pending = false;
+                m_busy = true;
+            }
+
+            // the main thread doesn't touch the back buffer or the stream while busy
+            const bool loaded = read(m_back, request_begin, request_size);
+
+            {
+                std::lock_guard lock{ m_mutex };
+                m_back_begin = request_begin;
+                m_back_size = loaded ? request_size : size_type{ 0 };
+                m_busy = false;
+            }
+
+            m_condition.notify_all();
+        }
+    }
+
+    bool read(std::vector<value_type>& buffer, size_type first, size_type count)
+    {
+        m_in.seek(m_stream_start_position + first * sizeof(value_type));
+        m_in.read(std::span(buffer).first(count));
+
+        if (!m_in)
+        {
+            m_in.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    istream_view m_in{};
+    std::vector<value_type> m_front{};
+    std::vector<value_type> m_back{};
+    sliding_window<size_type> m_sliding_window{};
+    size_type m_stream_start_position{};
+    size_type m_back_begin{};
+    size_type m_back_size{}; // 0 if nothing valid was prefetched
+    size_type m_step{};
+    travel_direction m_direction{ travel_direction::none };
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    size_type m_request_begin{};
+    size_type m_request_size{};
+    bool m_request_pending{ false };
+    bool m_busy{ false };
+    std::jthread m_worker{};
+};
+
+} // namespace flow
@@ -4,6 +4,7 @@
 #include <bit>
 #include <concepts>
 #include <cstddef>
+#include <iterator>
 #include <optional>
 #include <span>
 #include <vector>
@@ -27,12 +28,55 @@ private:
 
     static_assert(std::numeric_limits<block_type>::digits > level_bit_count, "size_type is too small");
 
+public:
+    // running totals since the partitioner was created
+    struct operation_counts
+    {
+        size_type allocs;
+        size_type failed_allocs;
+        size_type frees;
+        size_type splits;
+        size_type merges;
+    };
+
+    struct statistics
+    {
+        size_type requested_size;    // sum of the sizes passed to alloc by the live allocations
+        size_type allocated_size;    // sum of the block sizes reserved by the live allocations
+        size_type free_size;         // sum of the sizes of the free blocks
+        size_type largest_free_size; // size of the largest block that can currently be allocated
+        size_type allocation_count;  // number of live allocations
+        operation_counts operations;
+        std::vector<size_type> free_block_counts; // number of free blocks on each level
+
+        // fraction of the reserved size lost to rounding up to power of two blocks
+        [[nodiscard]] constexpr double internal_fragmentation() const noexcept
+        {
+            return allocated_size == 0
+                         ? 0.0
+                         : 1.0 - static_cast<double>(requested_size) / static_cast<double>(allocated_size);
+        }
+
+        // fraction of the free size that can't be allocated in one block
+        [[nodiscard]] constexpr double external_fragmentation() const noexcept
+        {
+            return free_size == 0
+                         ? 0.0
+                         : 1.0 - static_cast<double>(largest_free_size) / static_cast<double>(free_size);
+        }
+    };
+
 public:
     constexpr buddy_partitioner() noexcept
         : m_block_size{}
         , m_base_offset{}
         , m_blocks{}
         , m_freelists{}
+        , m_requested_sizes{}
+        , m_requested_size{}
+        , m_allocated_size{}
+        , m_allocation_count{}
+        , m_operations{}
     {}
 
     constexpr buddy_partitioner(size_type block_count, size_type block_size, size_type base_offset = 0)
@@ -54,12 +98,15 @@ public:
         m_base_offset = base_offset;
 
         size_type levels = fast_log2(pow2_block_count) + 1;
-        m_blocks.resize(pow2_block_count, make_block(nullindex, 0));
-        m_freelists.resize(levels);
+        m_blocks.assign(pow2_block_count, make_block(nullindex, 0));
+        m_freelists.assign(levels, {});
+        m_requested_sizes.assign(pow2_block_count, 0);
 
         m_blocks[0] = make_block(0, levels - 1);
         m_freelists.back().push_back(0);
 
+        reset_statistics();
+
         return pow2_block_count;
     }
 
@@ -78,16 +125,20 @@ public:
         m_block_size = block_size;
         m_base_offset = base_offset;
 
-        m_blocks.resize(blocks.size());
+        m_blocks.assign(blocks.begin(), blocks.end());
         m_freelists.resize(freelists.size());
 
-        std::copy(blocks.begin(), blocks.end(), m_blocks.begin());
-
         for (std::size_t level = 0; level < m_freelists.size(); ++level)
         {
-            std::copy(freelists[level].begin(), freelists[level].end(), m_freelists[level].begin());
+            m_freelists[level].assign(freelists[level].begin(), freelists[level].end());
         }
 
+        // the requested sizes of the restored allocations are unknown,
+        // so they are accounted as if they requested their whole blocks
+        m_requested_sizes.assign(blocks.size(), 0);
+
+        reset_statistics();
+
         return pow2_block_count;
     }
 
@@ -113,9 +164,12 @@ public:
         // there are no available free blocks
         if (free_level >= m_freelists.size())
         {
+            ++m_operations.failed_allocs;
             return std::nullopt;
         }
 
+        m_operations.splits += free_level - request_level;
+
         // remove the first free block found
         // as it will either be split or used as is
         const size_type block_index = m_freelists[free_level].back();
@@ -141,6 +195,12 @@ public:
         // or the left child of the last split block (that we never actually add to the freelist)
         m_blocks[block_index] = make_block(nullindex, free_level);
 
+        m_requested_sizes[block_index] = size;
+        m_requested_size += size;
+        m_allocated_size += m_block_size << free_level;
+        ++m_allocation_count;
+        ++m_operations.allocs;
+
         return m_base_offset + block_index * m_block_size;
     }
 
@@ -153,6 +213,13 @@ public:
 
         size_type free_level = get_block_level(m_blocks[block_index]);
 
+        const size_type requested_size = m_requested_sizes[block_index];
+        m_requested_size -= requested_size != 0 ? requested_size : m_block_size << free_level;
+        m_allocated_size -= m_block_size << free_level;
+        m_requested_sizes[block_index] = 0;
+        --m_allocation_count;
+        ++m_operations.frees;
+
         // update the block with the freelist entry, but don't push the block
         // to the freelist yet, since we might merge it with its buddy
         m_blocks[block_index] = make_block(m_freelists[free_level].size(), free_level);
@@ -181,7 +248,10 @@ public:
 
             // we only need to remove the buddy from the freelist, because we never
             // push the actual freed block until we finish the merge process
+            // both entries are reset, so the one that ends up inside the merged
+            // block can't be mistaken for a free buddy later on
             m_blocks[buddy_block_index] = make_block(nullindex, free_level);
+            m_blocks[block_index] = make_block(nullindex, free_level);
             m_freelists[free_level].pop_back();
 
             // update the block index with the index of the merged block,
@@ -191,6 +261,8 @@ public:
             // update the merged block, but don't add it to the freelist
             const size_type next_level = ++free_level;
             m_blocks[block_index] = make_block(m_freelists[next_level].size(), next_level);
+
+            ++m_operations.merges;
         }
 
         // push the freed block to the freelist
@@ -200,6 +272,99 @@ public:
         m_freelists[free_level].push_back(block_index);
     }
 
+    // allocates up to count blocks for the given size, splitting each free block once
+    // and handing out all of its children, returns the number of written offsets,
+    // which is less than count only if the partitioner runs out of free blocks
+    template<std::output_iterator<size_type> OutputIt>
+    [[nodiscard]] constexpr size_type alloc_n(size_type size, size_type count, OutputIt out)
+    {
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        const size_type request_level = size_to_level(size);
+        size_type allocated = 0;
+
+        while (allocated < count)
+        {
+            size_type free_level = request_level;
+
+            while (free_level < m_freelists.size() && m_freelists[free_level].empty())
+            {
+                ++free_level;
+            }
+
+            if (free_level >= m_freelists.size())
+            {
+                ++m_operations.failed_allocs;
+                break;
+            }
+
+            size_type block_index = m_freelists[free_level].back();
+            m_freelists[free_level].pop_back();
+
+            // number of request sized children to take from the free block
+            size_type take = std::min(count - allocated, static_cast<size_type>(1) << (free_level - request_level));
+            allocated += take;
+
+            // walk down the free block, the children in front of the taken
+            // range are handed out whole, the ones after it go back to the freelists
+            while (take > 0)
+            {
+                const size_type child_count = static_cast<size_type>(1) << (free_level - request_level);
+
+                if (take == child_count)
+                {
+                    for (size_type i = 0; i < child_count; ++i)
+                    {
+                        *out++ = take_block(block_index + (i << request_level), request_level, size);
+                    }
+
+                    m_operations.splits += child_count - 1;
+                    break;
+                }
+
+                const size_type next_level = --free_level;
+                const size_type half_count = child_count / 2;
+                const size_type right_block_index = block_index + (static_cast<size_type>(1) << next_level);
+
+                ++m_operations.splits;
+
+                if (take <= half_count)
+                {
+                    m_blocks[right_block_index] = make_block(m_freelists[next_level].size(), next_level);
+                    m_freelists[next_level].push_back(right_block_index);
+                }
+                else
+                {
+                    for (size_type i = 0; i < half_count; ++i)
+                    {
+                        *out++ = take_block(block_index + (i << request_level), request_level, size);
+                    }
+
+                    m_operations.splits += half_count - 1;
+                    block_index = right_block_index;
+                    take -= half_count;
+                }
+            }
+        }
+
+        return allocated;
+    }
+
+    // frees all the offsets, sorting them first so that the buddies
+    // are freed one after the other and merge as early as possible
+    constexpr void free_n(std::span<size_type> offsets)
+    {
+        std::sort(offsets.begin(), offsets.end());
+
+        for (const size_type offset : offsets)
+        {
+            free(offset);
+        }
+    }
+
     [[nodiscard]] constexpr std::span<const block_type> blocks() const noexcept
     {
         return m_blocks;
@@ -235,6 +400,83 @@ public:
         return m_block_size * block_count();
     }
 
+    // level of the allocated block that starts at offset,
+    // the size of the block being block_size() << level
+    [[nodiscard]] constexpr size_type block_level(size_type offset) const noexcept
+    {
+        return get_block_level(m_blocks[(offset - m_base_offset) / m_block_size]);
+    }
+
+    [[nodiscard]] constexpr size_type free_block_count(size_type level) const noexcept
+    {
+        return level < m_freelists.size() ? m_freelists[level].size() : 0;
+    }
+
+    [[nodiscard]] constexpr size_type largest_free_size() const noexcept
+    {
+        for (size_type level = m_freelists.size(); level > 0; --level)
+        {
+            if (!m_freelists[level - 1].empty())
+            {
+                return m_block_size << (level - 1);
+            }
+        }
+
+        return 0;
+    }
+
+    [[nodiscard]] constexpr size_type free_size() const noexcept
+    {
+        size_type size = 0;
+
+        for (size_type level = 0; level < m_freelists.size(); ++level)
+        {
+            size += (m_block_size << level) * m_freelists[level].size();
+        }
+
+        return size;
+    }
+
+    [[nodiscard]] constexpr size_type requested_size() const noexcept
+    {
+        return m_requested_size;
+    }
+
+    [[nodiscard]] constexpr size_type allocated_size() const noexcept
+    {
+        return m_allocated_size;
+    }
+
+    [[nodiscard]] constexpr size_type allocation_count() const noexcept
+    {
+        return m_allocation_count;
+    }
+
+    [[nodiscard]] constexpr const operation_counts& operations() const noexcept
+    {
+        return m_operations;
+    }
+
+    [[nodiscard]] constexpr statistics stats() const
+    {
+        statistics stats{
+            .requested_size = m_requested_size,
+            .allocated_size = m_allocated_size,
+            .free_size = free_size(),
+            .largest_free_size = largest_free_size(),
+            .allocation_count = m_allocation_count,
+            .operations = m_operations,
+            .free_block_counts = std::vector<size_type>(m_freelists.size())
+        };
+
+        for (size_type level = 0; level < m_freelists.size(); ++level)
+        {
+            stats.free_block_counts[level] = m_freelists[level].size();
+        }
+
+        return stats;
+    }
+
     [[nodiscard]] constexpr size_type max_allocations(size_type size) const noexcept
     {
         if (size == 0)
@@ -269,7 +511,45 @@ private:
     [[nodiscard]] constexpr size_type size_to_level(size_type size) const noexcept
     {
         const auto block_count = size / m_block_size + (size % m_block_size != 0);
-        return fast_log2(block_count);
+        return fast_log2(std::bit_ceil(block_count));
+    }
+
+    // marks the block as allocated and returns its offset
+    constexpr size_type take_block(size_type block_index, size_type level, size_type size) noexcept
+    {
+        m_blocks[block_index] = make_block(nullindex, level);
+
+        m_requested_sizes[block_index] = size;
+        m_requested_size += size;
+        m_allocated_size += m_block_size << level;
+        ++m_allocation_count;
+        ++m_operations.allocs;
+
+        return m_base_offset + block_index * m_block_size;
+    }
+
+    constexpr void reset_statistics() noexcept
+    {
+        m_requested_size = 0;
+        m_allocated_size = 0;
+        m_allocation_count = 0;
+        m_operations = {};
+
+        // the entry of the first block of every free or allocated
+        // block holds its level, so walking them visits every block
+        for (size_type block_index = 0; block_index < m_blocks.size();)
+        {
+            const size_type level = get_block_level(m_blocks[block_index]);
+
+            if (get_block_index(m_blocks[block_index]) == nullindex)
+            {
+                m_requested_size += m_block_size << level;
+                m_allocated_size += m_block_size << level;
+                ++m_allocation_count;
+            }
+
+            block_index += static_cast<size_type>(1) << level;
+        }
     }
 
     [[nodiscard]] static constexpr block_type make_block(size_type index, size_type level) noexcept
@@ -291,8 +571,8 @@ private:
     {
         const size_type lindex = get_block_index(lhs);
         const size_type rindex = get_block_index(rhs);
-        lhs &= (rindex << level_bit_count);
-        rhs &= (lindex << level_bit_count);
+        lhs = make_block(rindex, get_block_level(lhs));
+        rhs = make_block(lindex, get_block_level(rhs));
     }
 
 private:
@@ -300,6 +580,14 @@ private:
     size_type m_base_offset;
     std::vector<block_type> m_blocks;
     std::vector<std::vector<size_type>> m_freelists;
+    std::vector<size_type> m_requested_sizes;
+    size_type m_requested_size;
+    size_type m_allocated_size;
+    size_type m_allocation_count;
+    operation_counts m_operations;
+
+    template<std::integral BlockU, std::integral SizeU, std::size_t ShardCount>
+    friend class concurrent_buddy_partitioner;
 };
 
 } // namespace flow
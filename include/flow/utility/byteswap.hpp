@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "../core/assertion.hpp"
+#include "aggregate_members.hpp"
+#include "concepts.hpp"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(__SSSE3__)
+#  include <tmmintrin.h>
+#endif
+
+namespace flow {
+
+namespace detail {
+
+    template<std::size_t Size>
+    struct byteswap_unsigned;
+
+    template<>
+    struct byteswap_unsigned<2>
+    {
+        using type = std::uint16_t;
+    };
+
+    template<>
+    struct byteswap_unsigned<4>
+    {
+        using type = std::uint32_t;
+    };
+
+    template<>
+    struct byteswap_unsigned<8>
+    {
+        using type = std::uint64_t;
+    };
+
+    template<std::unsigned_integral T>
+    [[nodiscard]] constexpr T byteswap_integer(T value) noexcept
+    {
+        // compilers turn this into a single bswap instruction
+        T result{};
+
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            result = static_cast<T>((result << 8) | (value & 0xff));
+            value = static_cast<T>(value >> 8);
+        }
+
+        return result;
+    }
+
+    // shuffle mask that reverses the bytes of every Size byte element of a 32 byte vector
+    template<std::size_t Size>
+    [[nodiscard]] consteval std::array<std::uint8_t, 32> byteswap_shuffle_mask() noexcept
+    {
+        std::array<std::uint8_t, 32> mask{};
+
+        for (std::size_t i = 0; i < mask.size(); ++i)
+        {
+            // _mm256_shuffle_epi8 shuffles within 16 byte lanes
+            mask[i] = static_cast<std::uint8_t>((i % 16) / Size * Size + (Size - 1 - i % Size));
+        }
+
+        return mask;
+    }
+
+    // swaps the bytes of count elements of Size bytes from src to dst, which may be the same
+    template<std::size_t Size>
+    void byteswap_bytes(const std::byte* src, std::byte* dst, std::size_t count) noexcept
+    {
+        using unsigned_type = typename byteswap_unsigned<Size>::type;
+
+        const std::size_t size = count * Size;
+        std::size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+        static constexpr std::array<std::uint8_t, 32> mask_bytes = byteswap_shuffle_mask<Size>();
+#endif
+
+#if defined(__AVX2__)
+        // NOLINTBEGIN(*-reinterpret-cast)
+        const __m256i mask256 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask_bytes.data()));
+
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask256));
+        }
+        // NOLINTEND(*-reinterpret-cast)
+#endif
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+        // NOLINTBEGIN(*-reinterpret-cast)
+        const __m128i mask128 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask_bytes.data()));
+
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask128));
+        }
+        // NOLINTEND(*-reinterpret-cast)
+#endif
+
+        for (; i < size; i += Size)
+        {
+            unsigned_type value{};
+            std::memcpy(&value, src + i, Size);
+            value = byteswap_integer(value);
+            std::memcpy(dst + i, &value, Size);
+        }
+    }
+
+} // namespace detail
+
+template<concepts::byte_swappable T>
+[[nodiscard]] constexpr T byteswap(T value) noexcept
+{
+    using unsigned_type = typename detail::byteswap_unsigned<sizeof(T)>::type;
+
+    return std::bit_cast<T>(detail::byteswap_integer(std::bit_cast<unsigned_type>(value)));
+}
+
+// swaps the bytes of every value in place
+template<concepts::byte_swappable T>
+void byteswap(std::span<T> values) noexcept
+{
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    auto* bytes = reinterpret_cast<std::byte*>(values.data());
+    detail::byteswap_bytes<sizeof(T)>(bytes, bytes, values.size());
+}
+
+// writes the values of src with their bytes swapped to dst, which must be at least as large
+template<concepts::byte_swappable T>
+void byteswap(std::span<const T> src, std::span<T> dst) noexcept
+{
+    FLOW_ASSERT(dst.size() >= src.size(), "destination is too small");
+
+    // NOLINTBEGIN(*-reinterpret-cast)
+    detail::byteswap_bytes<sizeof(T)>(reinterpret_cast<const std::byte*>(src.data()),
+                                      reinterpret_cast<std::byte*>(dst.data()),
+                                      src.size());
+    // NOLINTEND(*-reinterpret-cast)
+}
+
+namespace detail {
+
+    template<typename T>
+    struct is_std_array : std::false_type
+    {};
+
+    template<typename T, std::size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type
+    {};
+
+    template<typename T>
+    [[nodiscard]] consteval bool is_byte_order_convertible() noexcept;
+
+    template<typename TupleT>
+    struct are_members_byte_order_convertible;
+
+    template<typename... Ts>
+    struct are_members_byte_order_convertible<std::tuple<Ts&...>>
+        : std::bool_constant<(is_byte_order_convertible<std::remove_cv_t<Ts>>() && ...)>
+    {};
+
+    template<typename T>
+    [[nodiscard]] consteval bool is_byte_order_convertible() noexcept
+    {
+        if constexpr (!concepts::trivially_copyable<T>)
+        {
+            return false;
+        }
+        else if constexpr (sizeof(T) == 1 || concepts::byte_swappable<T>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_array_v<T>)
+        {
+            return is_byte_order_convertible<std::remove_extent_t<T>>();
+        }
+        else if constexpr (is_std_array<T>::value)
+        {
+            return is_byte_order_convertible<typename T::value_type>();
+        }
+        else if constexpr (decomposable_aggregate<T>)
+        {
+            using members_type = decltype(tie_members<aggregate_member_count<T>()>(std::declval<T&>()));
+            return are_members_byte_order_convertible<members_type>::value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+} // namespace detail
+
+namespace concepts {
+
+    // trivially copyable types that can be converted between byte orders in place: single bytes,
+    // arithmetic and enum values, arrays of them and aggregates of all of these
+    template<typename T>
+    concept byte_order_convertible = detail::is_byte_order_convertible<T>();
+
+} // namespace concepts
+
+// swaps the bytes of every arithmetic and enum value in value, in place, padding is left as is
+template<concepts::byte_order_convertible T>
+constexpr void byteswap_members(T& value) noexcept
+{
+    if constexpr (sizeof(T) == 1)
+    {
+        return;
+    }
+    else if constexpr (concepts::byte_swappable<T>)
+    {
+        value = byteswap(value);
+    }
+    else if constexpr (std::is_array_v<T> || detail::is_std_array<T>::value)
+    {
+        for (auto& element : value)
+        {
+            byteswap_members(element);
+        }
+    }
+    else
+    {
+        std::apply([](auto&... members) { (byteswap_members(members), ...); },
+                   detail::tie_members<detail::aggregate_member_count<T>()>(value));
+    }
+}
+
+} // namespace flow
@@ -0,0 +1,455 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "aggregate_members.hpp"
+#include "byteswap.hpp"
+#include "istream_view.hpp"
+#include "ostream_view.hpp"
+#include "serialization.hpp"
+
+namespace flow {
+
+namespace detail {
+
+    inline constexpr std::uint64_t fnv1a_offset_basis = 0xcbf29ce484222325;
+    inline constexpr std::uint64_t fnv1a_prime = 0x100000001b3;
+
+    [[nodiscard]] constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = fnv1a_offset_basis) noexcept
+    {
+        for (const char c : str)
+        {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+
+    [[nodiscard]] constexpr std::uint64_t fnv1a(std::uint64_t value, std::uint64_t hash = fnv1a_offset_basis) noexcept
+    {
+        for (std::size_t i = 0; i < sizeof(value); ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= fnv1a_prime;
+        }
+
+        return hash;
+    }
+
+} // namespace detail
+
+// the identity of a type stored in chunks, specialize it with a name and a version for the types
+// that have no structural identity, or to keep the identity of a type whose structure changes
+// in a compatible way, e.g.
+//
+// template<>
+// struct flow::chunk_type<level>
+// {
+//     static constexpr std::string_view name = "level";
+//     static constexpr std::uint32_t version = 2;
+// };
+template<typename T>
+struct chunk_type
+{};
+
+namespace concepts {
+
+    template<typename T>
+    concept named_chunk_type = requires {
+        { chunk_type<T>::name } -> std::convertible_to<std::string_view>;
+        { chunk_type<T>::version } -> std::convertible_to<std::uint32_t>;
+    };
+
+} // namespace concepts
+
+namespace detail {
+
+    template<typename T>
+    struct is_vector : std::false_type
+    {};
+
+    template<typename T, typename AllocatorT>
+    struct is_vector<std::vector<T, AllocatorT>> : std::true_type
+    {};
+
+    template<typename T>
+    struct is_basic_string : std::false_type
+    {};
+
+    template<typename CharT, typename TraitsT, typename AllocatorT>
+    struct is_basic_string<std::basic_string<CharT, TraitsT, AllocatorT>> : std::true_type
+    {};
+
+    template<typename T>
+    concept character = concepts::any_of<T, char, wchar_t, char8_t, char16_t, char32_t>;
+
+    template<typename T>
+    [[nodiscard]] consteval bool is_identifiable_chunk_type() noexcept;
+
+    template<typename TupleT>
+    struct are_members_identifiable_chunk_types;
+
+    template<typename... Ts>
+    struct are_members_identifiable_chunk_types<std::tuple<Ts&...>>
+        : std::bool_constant<(is_identifiable_chunk_type<std::remove_cv_t<Ts>>() && ...)>
+    {};
+
+    template<typename T>
+    [[nodiscard]] consteval bool is_identifiable_chunk_type() noexcept
+    {
+        if constexpr (concepts::named_chunk_type<T> || std::is_arithmetic_v<T>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            return is_identifiable_chunk_type<std::underlying_type_t<T>>();
+        }
+        else if constexpr (std::is_bounded_array_v<T>)
+        {
+            return is_identifiable_chunk_type<std::remove_extent_t<T>>();
+        }
+        else if constexpr (is_std_array<T>::value || is_vector<T>::value || is_basic_string<T>::value)
+        {
+            return is_identifiable_chunk_type<typename T::value_type>();
+        }
+        else if constexpr (decomposable_aggregate<T> && std::default_initializable<T>)
+        {
+            using members_type = decltype(tie_members<aggregate_member_count<T>()>(std::declval<T&>()));
+            return are_members_identifiable_chunk_types<members_type>::value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+} // namespace detail
+
+namespace concepts {
+
+    // the types chunk_type_hash can identify: the ones with a name and a version, arithmetic and
+    // enum types, arrays, vectors and strings of them, and aggregates of all of these
+    template<typename T>
+    concept identifiable_chunk_type = detail::is_identifiable_chunk_type<T>();
+
+} // namespace concepts
+
+namespace detail {
+
+    // folds the identity of T into hash
+    template<concepts::identifiable_chunk_type T>
+    [[nodiscard]] std::uint64_t hash_chunk_type(std::uint64_t hash)
+    {
+        if constexpr (concepts::named_chunk_type<T>)
+        {
+            return fnv1a(chunk_type<T>::version, fnv1a(chunk_type<T>::name, fnv1a("named", hash)));
+        }
+        else if constexpr (std::same_as<T, bool>)
+        {
+            return fnv1a("bool", hash);
+        }
+        else if constexpr (character<T>)
+        {
+            // the signedness of char depends on the platform, so it is left out
+            return fnv1a(sizeof(T), fnv1a("char", hash));
+        }
+        else if constexpr (std::signed_integral<T>)
+        {
+            return fnv1a(sizeof(T), fnv1a("int", hash));
+        }
+        else if constexpr (std::unsigned_integral<T>)
+        {
+            return fnv1a(sizeof(T), fnv1a("uint", hash));
+        }
+        else if constexpr (std::floating_point<T>)
+        {
+            return fnv1a(sizeof(T), fnv1a("float", hash));
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            return hash_chunk_type<std::underlying_type_t<T>>(fnv1a("enum", hash));
+        }
+        else if constexpr (std::is_bounded_array_v<T>)
+        {
+            return hash_chunk_type<std::remove_extent_t<T>>(fnv1a(std::extent_v<T>, fnv1a("array", hash)));
+        }
+        else if constexpr (is_std_array<T>::value)
+        {
+            return hash_chunk_type<typename T::value_type>(fnv1a(std::tuple_size_v<T>, fnv1a("array", hash)));
+        }
+        else if constexpr (is_vector<T>::value)
+        {
+            return hash_chunk_type<typename T::value_type>(fnv1a("vector", hash));
+        }
+        else if constexpr (is_basic_string<T>::value)
+        {
+            return hash_chunk_type<typename T::value_type>(fnv1a("string", hash));
+        }
+        else
+        {
+            // the offsets of the members can't be taken in a constant expression, hence the value
+            const T value{};
+            const auto* base = reinterpret_cast<const std::byte*>(&value); // NOLINT(*-reinterpret-cast)
+
+            hash = fnv1a(aggregate_member_count<T>(), fnv1a(sizeof(T), fnv1a("aggregate", hash)));
+
+            std::apply(
+                [&](const auto&... members) {
+                    ((hash = hash_chunk_type<std::remove_cvref_t<decltype(members)>>(fnv1a(
+                          static_cast<std::uint64_t>(reinterpret_cast<const std::byte*>(&members) - base), // NOLINT(*-reinterpret-cast)
+                          hash))),
+                     ...);
+                },
+                tie_members<aggregate_member_count<T>()>(value));
+
+            return hash;
+        }
+    }
+
+} // namespace detail
+
+// identifies the type stored in a chunk, by its name and version if it has one, otherwise by its
+// structure: the kinds and sizes of its values and the offsets of its members, which stay the same
+// across compilers and renames, but change with the layout of the type
+// computed once, on first use
+template<concepts::identifiable_chunk_type T>
+[[nodiscard]] std::uint64_t chunk_type_hash()
+{
+    static const std::uint64_t hash = detail::hash_chunk_type<T>(detail::fnv1a_offset_basis);
+    return hash;
+}
+
+struct chunk_entry
+{
+    std::uint64_t name_hash;
+    std::uint64_t type_hash;
+    std::uint64_t offset; // from the start of the container
+    std::uint64_t size;
+};
+
+namespace detail {
+
+    inline constexpr std::uint32_t chunk_container_magic = 0x4b434c46; // "FLCK"
+    inline constexpr std::uint32_t chunk_container_format_version = 2;
+
+    struct chunk_container_header
+    {
+        std::uint32_t magic;
+        std::uint32_t format_version;
+        std::uint32_t version;
+        std::uint32_t chunk_count;
+        std::uint64_t table_offset;
+    };
+
+} // namespace detail
+
+// writes a container of named chunks: a header, the serialized chunks one after the other,
+// and a table with the type hash, offset and size of every chunk, which lets chunk_reader
+// seek directly to a chunk and skip the others without deserializing them
+// the stream must be seekable, since the header is patched by end
+class chunk_writer
+{
+public:
+    using pos_type = ostream_view::pos_type;
+    using off_type = ostream_view::off_type;
+
+public:
+    chunk_writer() noexcept = default;
+
+    // version is the application defined version of the content, returned by chunk_reader::version
+    bool begin(ostream_view out, std::uint32_t version = 0)
+    {
+        m_out = out;
+        m_start_position = out.tell();
+        m_version = version;
+        m_entries.clear();
+
+        return static_cast<bool>(out.write(make_header(0)));
+    }
+
+    template<concepts::identifiable_chunk_type T, concepts::serializer<T> SerializerT>
+    bool write(std::string_view name, const T& value, SerializerT serializer)
+    {
+        const pos_type position = m_out.tell();
+        m_out.serialize(value, serializer);
+        const pos_type end_position = m_out.tell();
+
+        if (!m_out)
+        {
+            return false;
+        }
+
+        m_entries.push_back({
+            .name_hash = detail::fnv1a(name),
+            .type_hash = chunk_type_hash<T>(),
+            .offset = static_cast<std::uint64_t>(position - m_start_position),
+            .size = static_cast<std::uint64_t>(end_position - position),
+        });
+
+        return true;
+    }
+
+    template<concepts::identifiable_chunk_type T>
+    bool write(std::string_view name, const T& value)
+    {
+        return write(name, value, serializer<T>{});
+    }
+
+    // writes the table and patches the header, leaves the stream at the end of the container
+    bool end()
+    {
+        const pos_type table_position = m_out.tell();
+        m_out.write(std::span<const chunk_entry>(m_entries));
+        const pos_type end_position = m_out.tell();
+
+        m_out.seek(m_start_position)
+            .write(make_header(static_cast<std::uint64_t>(table_position - m_start_position)))
+            .seek(end_position);
+
+        return static_cast<bool>(m_out);
+    }
+
+    [[nodiscard]] constexpr std::span<const chunk_entry> entries() const noexcept
+    {
+        return m_entries;
+    }
+
+private:
+    [[nodiscard]] detail::chunk_container_header make_header(std::uint64_t table_offset) const noexcept
+    {
+        return {
+            .magic = detail::chunk_container_magic,
+            .format_version = detail::chunk_container_format_version,
+            .version = m_version,
+            .chunk_count = static_cast<std::uint32_t>(m_entries.size()),
+            .table_offset = table_offset,
+        };
+    }
+
+private:
+    ostream_view m_out{};
+    pos_type m_start_position{};
+    std::uint32_t m_version{};
+    std::vector<chunk_entry> m_entries{};
+};
+
+// reads the table of a container written by chunk_writer, chunks are only read on request
+class chunk_reader
+{
+public:
+    using pos_type = istream_view::pos_type;
+    using off_type = istream_view::off_type;
+
+public:
+    chunk_reader() noexcept = default;
+
+    bool open(istream_view in)
+    {
+        m_in = in;
+        m_start_position = in.tell();
+        m_entries.clear();
+
+        detail::chunk_container_header header{};
+        in.read(header);
+
+        if (!in || header.magic != detail::chunk_container_magic
+            || header.format_version != detail::chunk_container_format_version)
+        {
+            return false;
+        }
+
+        // the table must fit between its offset and the end of the stream before it is allocated
+        in.seek(0, istream_view::end);
+        const auto container_size = static_cast<std::uint64_t>(in.tell() - m_start_position);
+
+        if (!in || header.table_offset > container_size
+            || header.chunk_count > (container_size - header.table_offset) / sizeof(chunk_entry))
+        {
+            return false;
+        }
+
+        m_version = header.version;
+        m_entries.resize(header.chunk_count);
+
+        in.seek(m_start_position + static_cast<off_type>(header.table_offset)).read(std::span(m_entries));
+
+        return static_cast<bool>(in);
+    }
+
+    [[nodiscard]] const chunk_entry* find(std::string_view name) const noexcept
+    {
+        const std::uint64_t name_hash = detail::fnv1a(name);
+        const auto it = std::ranges::find(m_entries, name_hash, &chunk_entry::name_hash);
+
+        return it != m_entries.end() ? &*it : nullptr;
+    }
+
+    [[nodiscard]] bool contains(std::string_view name) const noexcept
+    {
+        return find(name) != nullptr;
+    }
+
+    // positions the stream at the start of the chunk, for reading it by hand,
+    // returns nullptr if there is no such chunk
+    const chunk_entry* seek(std::string_view name)
+    {
+        const chunk_entry* entry = find(name);
+
+        if (entry)
+        {
+            m_in.seek(m_start_position + static_cast<off_type>(entry->offset));
+        }
+
+        return entry;
+    }
+
+    // returns false without reading if there is no such chunk or if it holds a different type
+    template<concepts::identifiable_chunk_type T, concepts::deserializer<T> DeserializerT>
+    bool read(std::string_view name, T& value, DeserializerT deserializer)
+    {
+        const chunk_entry* entry = find(name);
+
+        if (!entry || entry->type_hash != chunk_type_hash<T>())
+        {
+            return false;
+        }
+
+        m_in.seek(m_start_position + static_cast<off_type>(entry->offset)).deserialize(value, deserializer);
+
+        return static_cast<bool>(m_in);
+    }
+
+    template<concepts::identifiable_chunk_type T>
+    bool read(std::string_view name, T& value)
+    {
+        return read(name, value, deserializer<T>{});
+    }
+
+    [[nodiscard]] constexpr std::uint32_t version() const noexcept
+    {
+        return m_version;
+    }
+
+    [[nodiscard]] constexpr std::span<const chunk_entry> entries() const noexcept
+    {
+        return m_entries;
+    }
+
+private:
+    istream_view m_in{};
+    pos_type m_start_position{};
+    std::uint32_t m_version{};
+    std::vector<chunk_entry> m_entries{};
+};
+
+} // namespace flow
@@ -84,6 +84,10 @@ concept arithmetic = std::integral<T> || single_precision_float<T> || double_pre
 template<typename T>
 concept non_boolean_arithmetic = arithmetic<T> && !boolean<T>;
 
+template<typename T>
+concept byte_swappable = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                      && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
 template<typename T, typename... Args>
 concept any_of = (... || std::same_as<T, Args>);
 
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "buddy_partitioner.hpp"
+
+namespace flow {
+
+// thread safe buddy_partitioner with the same offset returning api
+// small blocks are served from per-thread-ish caches (shards selected by the thread id),
+// which are refilled from and flushed to the shared partitioner in batches, so the
+// shared lock is only taken once every cache_batch_size small allocations or frees
+template<std::integral BlockT, std::integral SizeT = std::size_t, std::size_t ShardCount = 8>
+class concurrent_buddy_partitioner
+{
+public:
+    using partitioner_type = buddy_partitioner<BlockT, SizeT>;
+    using block_type = typename partitioner_type::block_type;
+    using size_type = typename partitioner_type::size_type;
+    using statistics = typename partitioner_type::statistics;
+
+    static constexpr std::size_t shard_count = ShardCount;
+    static constexpr size_type cached_level_count = 4;
+    static constexpr size_type cache_batch_size = 16;
+
+    static_assert(shard_count > 0, "at least one shard is required");
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) shard
+    {
+        std::mutex mutex;
+        std::array<std::vector<size_type>, cached_level_count> cache;
+    };
+
+public:
+    concurrent_buddy_partitioner() noexcept = default;
+
+    concurrent_buddy_partitioner(size_type block_count, size_type block_size, size_type base_offset = 0)
+    {
+        create(block_count, block_size, base_offset);
+    }
+
+    concurrent_buddy_partitioner(const concurrent_buddy_partitioner& other) = delete;
+    concurrent_buddy_partitioner& operator=(const concurrent_buddy_partitioner& other) = delete;
+
+    // not thread safe, must be called before the partitioner is shared between threads
+    size_type create(size_type block_count, size_type block_size, size_type base_offset = 0)
+    {
+        for (auto& s : m_shards)
+        {
+            for (auto& cache : s.cache)
+            {
+                cache.clear();
+                cache.reserve(cache_batch_size * 2);
+            }
+        }
+
+        return m_partitioner.create(block_count, block_size, base_offset);
+    }
+
+    [[nodiscard]] std::optional<size_type> alloc(size_type size)
+    {
+        if (size == 0)
+        {
+            return std::nullopt;
+        }
+
+        const size_type level = m_partitioner.size_to_level(size);
+
+        if (level >= cached_level_count)
+        {
+            if (auto offset = alloc_shared(size))
+            {
+                return offset;
+            }
+        }
+        else
+        {
+            shard& s = current_shard();
+            std::unique_lock shard_lock{ s.mutex };
+            auto& cache = s.cache[level];
+
+            if (cache.empty())
+            {
+                refill(cache, level);
+            }
+
+            if (!cache.empty())
+            {
+                const size_type offset = cache.back();
+                cache.pop_back();
+
+                return offset;
+            }
+        }
+
+        // the shared partitioner might be exhausted only because the free blocks are
+        // scattered in the caches of the other shards, so return them and try again
+        trim();
+
+        return alloc_shared(size);
+    }
+
+    void free(size_type offset)
+    {
+        // the level entry of an allocated block is only ever written by
+        // the alloc that handed it out and by its own free, so it can be read
+        // without taking the shared lock
+        const size_type level = m_partitioner.block_level(offset);
+
+        if (level >= cached_level_count)
+        {
+            std::lock_guard lock{ m_mutex };
+            m_partitioner.free(offset);
+
+            return;
+        }
+
+        shard& s = current_shard();
+        std::lock_guard shard_lock{ s.mutex };
+        auto& cache = s.cache[level];
+
+        cache.push_back(offset);
+
+        if (cache.size() >= cache_batch_size * 2)
+        {
+            flush(cache, cache_batch_size);
+        }
+    }
+
+    // returns all the cached blocks to the shared partitioner
+    void trim()
+    {
+        for (auto& s : m_shards)
+        {
+            std::lock_guard shard_lock{ s.mutex };
+
+            for (auto& cache : s.cache)
+            {
+                flush(cache, cache.size());
+            }
+        }
+    }
+
+    [[nodiscard]] size_type max_allocations(size_type size)
+    {
+        trim();
+
+        std::lock_guard lock{ m_mutex };
+        return m_partitioner.max_allocations(size);
+    }
+
+    // blocks held by the caches are accounted as allocated
+    [[nodiscard]] statistics stats()
+    {
+        std::lock_guard lock{ m_mutex };
+        return m_partitioner.stats();
+    }
+
+    [[nodiscard]] size_type block_size() const noexcept
+    {
+        return m_partitioner.block_size();
+    }
+
+    [[nodiscard]] size_type base() const noexcept
+    {
+        return m_partitioner.base();
+    }
+
+    [[nodiscard]] size_type block_count() const noexcept
+    {
+        return m_partitioner.block_count();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return m_partitioner.capacity();
+    }
+
+private:
+    [[nodiscard]] shard& current_shard() noexcept
+    {
+        return m_shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % shard_count];
+    }
+
+    [[nodiscard]] std::optional<size_type> alloc_shared(size_type size)
+    {
+        std::lock_guard lock{ m_mutex };
+        return m_partitioner.alloc(size);
+    }
+
+    // expects the lock of the shard that owns the cache to be held
+    void refill(std::vector<size_type>& cache, size_type level)
+    {
+        const size_type size = m_partitioner.block_size() << level;
+
+        std::lock_guard lock{ m_mutex };
+        std::ignore = m_partitioner.alloc_n(size, cache_batch_size, std::back_inserter(cache));
+    }
+
+    // expects the lock of the shard that owns the cache to be held
+    void flush(std::vector<size_type>& cache, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::lock_guard lock{ m_mutex };
+        m_partitioner.free_n(std::span(cache).last(count));
+        cache.resize(cache.size() - count);
+    }
+
+private:
+    partitioner_type m_partitioner{};
+    std::mutex m_mutex{};
+    std::array<shard, shard_count> m_shards{};
+};
+
+} // namespace flow
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <functional>
 #include <limits>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -12,6 +13,7 @@
 #include "ostream_view.hpp"
 #include "traits.hpp"
 #include "vector_serialization.hpp"
+#include "vector_view.hpp"
 
 namespace flow {
 
@@ -649,6 +651,10 @@ private:
     friend class detail::dfs_iterator<std::add_const_t<dense_tree>>;
     friend class serializer<dense_tree>;
     friend class deserializer<dense_tree>;
+
+    template<typename TreeT>
+        requires concepts::trivially_copyable<typename TreeT::node_type>
+    friend class dense_tree_view;
 };
 
 template<typename T, std::unsigned_integral IndexT>
@@ -685,4 +691,106 @@ struct deserializer<dense_tree<T, IndexT, OrderedChildren, ChildrenCompT>>
     }
 };
 
+// read-only view over a serialized dense_tree, that exposes the node slots and
+// the free slot indices as spans into the underlying memory when deserialized
+// from a memory backed istream_view (e.g. a mapped_file), so loading is O(1)
+// the serialized node slots start sizeof(index_type) + 8 bytes after the tree, they are only
+// viewed in place if that offset keeps them aligned, otherwise they are copied, see vector_view
+template<typename TreeT>
+    requires concepts::trivially_copyable<typename TreeT::node_type>
+class dense_tree_view
+{
+public:
+    using tree_type = TreeT;
+    using value_type = typename tree_type::value_type;
+    using index_type = typename tree_type::index_type;
+    using node_type = typename tree_type::node_type;
+
+public:
+    constexpr dense_tree_view() noexcept = default;
+
+    [[nodiscard]] constexpr index_type root_index() const noexcept
+    {
+        return m_root_index;
+    }
+
+    [[nodiscard]] constexpr std::span<const node_type> node_slots() const noexcept
+    {
+        return m_node_slots.values();
+    }
+
+    [[nodiscard]] constexpr std::span<const index_type> free_slot_indices() const noexcept
+    {
+        return m_free_slot_indices.values();
+    }
+
+    [[nodiscard]] constexpr const value_type& value_at(index_type index) const noexcept
+    {
+        return m_node_slots[index].value;
+    }
+
+    [[nodiscard]] constexpr index_type parent_index_of(index_type index) const noexcept
+    {
+        return m_node_slots[index].indices.parent;
+    }
+
+    [[nodiscard]] constexpr index_type first_child_index_of(index_type index) const noexcept
+    {
+        return m_node_slots[index].indices.first_child;
+    }
+
+    [[nodiscard]] constexpr index_type next_sibling_index_of(index_type index) const noexcept
+    {
+        return m_node_slots[index].indices.next_sibling;
+    }
+
+    [[nodiscard]] constexpr bool is_node(index_type index) const noexcept
+    {
+        return index < m_node_slots.size()
+                && ((index != m_root_index && tree_type::is_valid_non_root(m_node_slots[index]))
+                    || (index == m_root_index && tree_type::is_valid_root(m_node_slots[index])));
+    }
+
+    // copies the viewed nodes into an owning, modifiable tree
+    [[nodiscard]] tree_type to_tree() const
+    {
+        tree_type tree{};
+        tree.m_root_index = m_root_index;
+        tree.m_node_slots = m_node_slots.to_vector();
+        tree.m_free_slot_indices = m_free_slot_indices.to_vector();
+
+        return tree;
+    }
+
+private:
+    index_type m_root_index{ tree_type::end_index };
+    vector_view<node_type> m_node_slots{};
+    vector_view<index_type> m_free_slot_indices{};
+
+    friend struct serializer<dense_tree_view>;
+    friend struct deserializer<dense_tree_view>;
+};
+
+template<typename TreeT>
+struct serializer<dense_tree_view<TreeT>>
+{
+    void operator()(ostream_view out, const dense_tree_view<TreeT>& t) const
+    {
+        out.serialize(t.m_root_index);
+        out.serialize(t.m_node_slots);
+        out.serialize(t.m_free_slot_indices);
+    }
+};
+
+template<typename TreeT>
+struct deserializer<dense_tree_view<TreeT>>
+{
+    void operator()(istream_view in, dense_tree_view<TreeT>& t) const
+    {
+        in.deserialize(t.m_root_index);
+        in.deserialize(t.m_node_slots);
+        in.deserialize(t.m_free_slot_indices);
+    }
+};
+
 } // namespace flow
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ios>
+#include <span>
+#include <vector>
+
+#include "stream_backend.hpp"
+
+namespace flow {
+
+// binary file stream backend that reads and writes with positional os calls
+// (pread and pwrite, or their win32 equivalents) through one large user-space buffer,
+// reads and writes larger than the buffer bypass it,
+// seeks that land inside the buffered bytes don't touch the file at all
+// like std::filebuf, reading and writing share the same position and buffer,
+// but the read and write states are separate, as seen by istream_view and ostream_view
+class file_stream final
+    : public istream_backend
+    , public ostream_backend
+{
+public:
+    using pos_type = istream_backend::pos_type;
+    using off_type = istream_backend::off_type;
+    using seekdir = istream_backend::seekdir;
+    using iostate = istream_backend::iostate;
+    using openmode = std::ios_base::openmode;
+
+    static constexpr std::size_t default_buffer_size = 1 << 16;
+
+public:
+    file_stream() noexcept = default;
+
+    explicit file_stream(const std::filesystem::path& path,
+                         openmode mode = std::ios_base::in,
+                         std::size_t buffer_size = default_buffer_size)
+    {
+        open(path, mode, buffer_size);
+    }
+
+    ~file_stream() override
+    {
+        close();
+    }
+
+    // the supported modes are in, out, in | out, and any of them combined with trunc,
+    // the file is created if it doesn't exist and out is set
+    bool open(const std::filesystem::path& path,
+              openmode mode = std::ios_base::in,
+              std::size_t buffer_size = default_buffer_size);
+
+    // flushes the buffered writes and closes the file, returns false if the flush failed
+    bool close();
+
+    [[nodiscard]] constexpr bool is_open() const noexcept
+    {
+        return m_handle != invalid_handle;
+    }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return is_open();
+    }
+
+private:
+    enum class buffer_mode : std::uint8_t
+    {
+        none,
+        reading,
+        writing,
+    };
+
+    static constexpr std::intptr_t invalid_handle = -1;
+
+    std::size_t do_read(std::span<std::byte> bytes) override;
+    bool do_seekg(off_type offset, seekdir direction) override;
+    [[nodiscard]] pos_type do_tellg() override;
+
+    std::size_t do_write(std::span<const std::byte> bytes) override;
+    bool do_seekp(off_type offset, seekdir direction) override;
+    [[nodiscard]] pos_type do_tellp() override;
+    bool do_flush() override;
+
+    bool seek_to(off_type offset, seekdir direction);
+
+    // writes the buffered bytes, or drops the buffered reads, and leaves the buffer unused
+    // at the same position
+    bool flush_buffer();
+
+    [[nodiscard]] std::uint64_t position() const noexcept;
+
+    std::size_t read_at(std::span<std::byte> bytes, std::uint64_t offset) const;
+    std::size_t write_at(std::span<const std::byte> bytes, std::uint64_t offset) const;
+    [[nodiscard]] bool file_size(std::uint64_t& size) const;
+
+private:
+    std::intptr_t m_handle{ invalid_handle };
+    std::vector<std::byte> m_buffer{};
+    std::uint64_t m_buffer_position{}; // file offset of the first buffered byte
+    buffer_mode m_mode{ buffer_mode::none };
+};
+
+} // namespace flow
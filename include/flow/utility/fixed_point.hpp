@@ -110,6 +110,19 @@ public:
         return m_value != 0;
     }
 
+    [[nodiscard]] static constexpr basic_fixed_point from_raw(underlying_type value) noexcept
+    {
+        basic_fixed_point num;
+        num.m_value = value;
+
+        return num;
+    }
+
+    [[nodiscard]] constexpr underlying_type raw() const noexcept
+    {
+        return m_value;
+    }
+
 private:
     underlying_type m_value;
 };
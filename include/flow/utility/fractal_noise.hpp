@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "../core/assertion.hpp"
+#include "noise.hpp"
+
+namespace flow {
+
+enum class fractal_type : std::uint8_t
+{
+    fbm,    // sum of the octaves
+    ridged, // sum of the octaves folded to sharp ridges where they cross 0
+};
+
+template<typename T>
+struct fractal_parameters
+{
+    std::size_t octave_count{ 4 };
+    T frequency{ 1 };
+    T lacunarity{ 2 }; // frequency multiplier between octaves
+    T gain{ static_cast<T>(0.5) }; // amplitude multiplier between octaves
+    fractal_type type{ fractal_type::fbm };
+    T warp_amplitude{ 0 }; // how far the points are displaced by the domain warp, 0 disables it
+    T warp_frequency{ 1 };
+};
+
+// sums octaves of a 2d noise generator, optionally after warping the points with the same noise
+// the result is normalized by the sum of the amplitudes, so fbm stays in the range of the
+// generator and ridged noise in [0, 1]
+// every batch of points is evaluated octave by octave with the batched kernel of the generator
+template<typename GeneratorT>
+class basic_fractal_noise
+{
+public:
+    using generator_type = GeneratorT;
+    using value_type = typename generator_type::value_type;
+    using point_type = glm::vec<2, value_type, glm::packed_highp>;
+    using parameters_type = fractal_parameters<value_type>;
+
+public:
+    basic_fractal_noise(std::uint64_t seed, const parameters_type& parameters = {})
+        : basic_fractal_noise(generator_type(seed), parameters)
+    {}
+
+    basic_fractal_noise(generator_type generator, const parameters_type& parameters = {})
+        : m_generator(std::move(generator))
+    {
+        set_parameters(parameters);
+    }
+
+    [[nodiscard]] value_type operator()(value_type x, value_type y) const
+    {
+        value_type value{};
+        evaluate(std::span(&x, 1), std::span(&y, 1), std::span(&value, 1));
+        return value;
+    }
+
+    [[nodiscard]] value_type operator()(point_type point) const
+    {
+        return operator()(point.x, point.y);
+    }
+
+    void evaluate(std::span<const value_type> xs, std::span<const value_type> ys, std::span<value_type> values) const
+    {
+        FLOW_ASSERT(xs.size() == values.size() && ys.size() == values.size(), "span sizes don't match");
+
+        for (std::size_t i = 0; i < values.size(); i += batch_size)
+        {
+            const std::size_t count = std::min(batch_size, values.size() - i);
+            evaluate_batch(xs.subspan(i, count), ys.subspan(i, count), values.subspan(i, count));
+        }
+    }
+
+    // values[y * width + x] = noise(origin.x + x * step.x, origin.y + y * step.y)
+    void fill(std::span<value_type> values, point_type origin, point_type step, std::size_t width, std::size_t height) const
+    {
+        fill_rows(values, origin, step, width, 0, height);
+    }
+
+    // same as fill, with the rows split in bands that are filled by thread_count threads,
+    // or by one thread per core if thread_count is 0
+    void fill_parallel(std::span<value_type> values,
+                       point_type origin,
+                       point_type step,
+                       std::size_t width,
+                       std::size_t height,
+                       std::size_t thread_count = 0) const
+    {
+        FLOW_ASSERT(values.size() >= width * height, "values span is too small");
+
+        const std::size_t band_count = (height + parallel_band_height - 1) / parallel_band_height;
+
+        if (thread_count == 0)
+        {
+            thread_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        }
+
+        thread_count = std::min(thread_count, band_count);
+
+        if (thread_count <= 1)
+        {
+            fill(values, origin, step, width, height);
+            return;
+        }
+
+        std::atomic<std::size_t> next_band{ 0 };
+
+        const auto work = [&] {
+            for (std::size_t band = next_band++; band < band_count; band = next_band++)
+            {
+                const std::size_t first = band * parallel_band_height;
+                fill_rows(values, origin, step, width, first, std::min(first + parallel_band_height, height));
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers{};
+            workers.reserve(thread_count - 1);
+
+            for (std::size_t i = 1; i < thread_count; ++i)
+            {
+                workers.emplace_back(work);
+            }
+
+            work();
+        }
+    }
+
+    void set_parameters(const parameters_type& parameters) noexcept
+    {
+        m_parameters = parameters;
+
+        value_type amplitude{ 1 };
+        value_type amplitude_sum{};
+
+        for (std::size_t i = 0; i < parameters.octave_count; ++i)
+        {
+            amplitude_sum += amplitude;
+            amplitude *= parameters.gain;
+        }
+
+        m_normalizer = amplitude_sum != value_type{ 0 } ? value_type{ 1 } / amplitude_sum : value_type{ 0 };
+    }
+
+    [[nodiscard]] constexpr const parameters_type& parameters() const noexcept
+    {
+        return m_parameters;
+    }
+
+    [[nodiscard]] constexpr const generator_type& generator() const noexcept
+    {
+        return m_generator;
+    }
+
+private:
+    static constexpr std::size_t batch_size = 256;
+    static constexpr std::size_t parallel_band_height = 16;
+
+    // offset between the two warp noise samples, so that they are not correlated
+    static constexpr value_type warp_offset_x = static_cast<value_type>(5.2);
+    static constexpr value_type warp_offset_y = static_cast<value_type>(1.3);
+
+    using batch_type = std::array<value_type, batch_size>;
+
+    void fill_rows(std::span<value_type> values,
+                   point_type origin,
+                   point_type step,
+                   std::size_t width,
+                   std::size_t first_row,
+                   std::size_t last_row) const
+    {
+        FLOW_ASSERT(values.size() >= width * last_row, "values span is too small");
+
+        std::vector<value_type> xs(width);
+        std::vector<value_type> ys(width);
+
+        for (std::size_t x = 0; x < width; ++x)
+        {
+            xs[x] = origin.x + static_cast<value_type>(x) * step.x;
+        }
+
+        for (std::size_t y = first_row; y < last_row; ++y)
+        {
+            std::fill(ys.begin(), ys.end(), origin.y + static_cast<value_type>(y) * step.y);
+            evaluate(xs, ys, values.subspan(y * width, width));
+        }
+    }
+
+    // evaluates at most batch_size points
+    void evaluate_batch(std::span<const value_type> xs, std::span<const value_type> ys, std::span<value_type> values) const
+    {
+        const std::size_t count = values.size();
+
+        batch_type x{};
+        batch_type y{};
+        batch_type scaled_x{};
+        batch_type scaled_y{};
+        batch_type noise{};
+
+        std::copy(xs.begin(), xs.end(), x.begin());
+        std::copy(ys.begin(), ys.end(), y.begin());
+
+        if (m_parameters.warp_amplitude != value_type{ 0 })
+        {
+            warp(std::span(x).first(count), std::span(y).first(count), scaled_x, scaled_y, noise);
+        }
+
+        std::fill_n(values.begin(), count, value_type{ 0 });
+
+        value_type frequency = m_parameters.frequency;
+        value_type amplitude{ 1 };
+
+        for (std::size_t octave = 0; octave < m_parameters.octave_count; ++octave)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                scaled_x[i] = x[i] * frequency;
+                scaled_y[i] = y[i] * frequency;
+            }
+
+            m_generator.evaluate(std::span<const value_type>(scaled_x).first(count),
+                                 std::span<const value_type>(scaled_y).first(count),
+                                 std::span(noise).first(count));
+
+            if (m_parameters.type == fractal_type::ridged)
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const value_type ridge = value_type{ 1 } - std::abs(noise[i]);
+                    values[i] += ridge * ridge * amplitude;
+                }
+            }
+            else
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    values[i] += noise[i] * amplitude;
+                }
+            }
+
+            frequency *= m_parameters.lacunarity;
+            amplitude *= m_parameters.gain;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] *= m_normalizer;
+        }
+    }
+
+    // displaces the points by two noise samples taken around them
+    void warp(std::span<value_type> x,
+              std::span<value_type> y,
+              batch_type& scaled_x,
+              batch_type& scaled_y,
+              batch_type& noise) const
+    {
+        const std::size_t count = x.size();
+        const value_type frequency = m_parameters.warp_frequency;
+        const value_type amplitude = m_parameters.warp_amplitude;
+
+        batch_type offset_x{};
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scaled_x[i] = x[i] * frequency;
+            scaled_y[i] = y[i] * frequency;
+        }
+
+        m_generator.evaluate(std::span<const value_type>(scaled_x).first(count),
+                             std::span<const value_type>(scaled_y).first(count),
+                             std::span(offset_x).first(count));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scaled_x[i] += warp_offset_x;
+            scaled_y[i] += warp_offset_y;
+        }
+
+        m_generator.evaluate(std::span<const value_type>(scaled_x).first(count),
+                             std::span<const value_type>(scaled_y).first(count),
+                             std::span(noise).first(count));
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            x[i] += offset_x[i] * amplitude;
+            y[i] += noise[i] * amplitude;
+        }
+    }
+
+private:
+    generator_type m_generator;
+    parameters_type m_parameters{};
+    value_type m_normalizer{ 1 };
+};
+
+// the fractal noise is 2d only, N is there to read like noise_generator<N>
+template<std::size_t N>
+    requires(N == 2)
+using fractal_noise_generator = basic_fractal_noise<noise_generator<N>>;
+
+} // namespace flow
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bit>
+#include <concepts>
 #include <span>
 
 #include "concepts.hpp"
@@ -36,10 +38,18 @@ public:
         : iostream_view(&in_out)
     {}
 
+    // for backends that can both read and write, like file_stream
+    template<typename BackendT>
+        requires std::derived_from<BackendT, istream_backend> && std::derived_from<BackendT, ostream_backend>
+    constexpr iostream_view(BackendT& in_out) noexcept
+        : m_in_backend{ &in_out }
+        , m_out_backend{ &in_out }
+    {}
+
     template<concepts::trivially_copyable T>
     iostream_view& read(T& data)
     {
-        istream_view(m_in_out).read(data);
+        in_view().read(data);
 
         return *this;
     }
@@ -47,7 +57,7 @@ public:
     template<concepts::trivially_copyable T>
     iostream_view& read(std::span<T> span)
     {
-        istream_view(m_in_out).read(span);
+        in_view().read(span);
 
         return *this;
     }
@@ -55,7 +65,7 @@ public:
     template<concepts::trivially_copyable T>
     iostream_view& write(const T& data)
     {
-        ostream_view(m_in_out).write(data);
+        out_view().write(data);
 
         return *this;
     }
@@ -63,7 +73,7 @@ public:
     template<concepts::trivially_copyable T>
     iostream_view& write(std::span<T> span)
     {
-        ostream_view(m_in_out).write(span);
+        out_view().write(span);
 
         return *this;
     }
@@ -71,7 +81,7 @@ public:
     template<concepts::trivially_copyable T>
     iostream_view& write(std::span<const T> span)
     {
-        ostream_view(m_in_out).write(span);
+        out_view().write(span);
 
         return *this;
     }
@@ -79,7 +89,7 @@ public:
     template<typename T, concepts::serializer<T> SerializerT>
     iostream_view& serialize(const T& data, SerializerT serializer)
     {
-        ostream_view(m_in_out).serialize(data, serializer);
+        out_view().serialize(data, serializer);
 
         return *this;
     }
@@ -93,7 +103,7 @@ public:
     template<typename T, concepts::deserializer<T> DeserializerT>
     iostream_view& deserialize(T& data, DeserializerT deserializer)
     {
-        istream_view(m_in_out).deserialize(data, deserializer);
+        in_view().deserialize(data, deserializer);
 
         return *this;
     }
@@ -106,85 +116,124 @@ public:
 
     iostream_view& seekg(pos_type position)
     {
-        istream_view(m_in_out).seek(position);
+        in_view().seek(position);
         return *this;
     }
 
     iostream_view& seekg(off_type offset, seekdir direction)
     {
-        istream_view(m_in_out).seek(offset, direction);
+        in_view().seek(offset, direction);
         return *this;
     }
 
     iostream_view& seekp(pos_type position)
     {
-        ostream_view(m_in_out).seek(position);
+        out_view().seek(position);
         return *this;
     }
 
     iostream_view& seekp(off_type offset, seekdir direction)
     {
-        ostream_view(m_in_out).seek(offset, direction);
+        out_view().seek(offset, direction);
         return *this;
     }
 
     [[nodiscard]] pos_type tellg()
     {
-        return istream_view(m_in_out).tell();
+        return in_view().tell();
     }
 
     [[nodiscard]] pos_type tellp()
     {
-        return ostream_view(m_in_out).tell();
+        return out_view().tell();
+    }
+
+    // the byte order that arithmetic and enum values are read and written in,
+    // see ostream_view::set_byte_order
+    constexpr iostream_view& set_byte_order(std::endian order) noexcept
+    {
+        m_byte_order = order;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr std::endian byte_order() const noexcept
+    {
+        return m_byte_order;
+    }
+
+    [[nodiscard]] constexpr bool is_native_byte_order() const noexcept
+    {
+        return m_byte_order == std::endian::native;
     }
 
     [[nodiscard]] bool good() const
     {
-        return istream_view(m_in_out).good();
+        return in_view().good();
     }
 
     [[nodiscard]] bool eof() const
     {
-        return istream_view(m_in_out).eof();
+        return in_view().eof();
     }
 
     [[nodiscard]] bool fail() const
     {
-        return istream_view(m_in_out).fail();
+        return in_view().fail();
     }
 
     [[nodiscard]] bool bad() const
     {
-        return istream_view(m_in_out).bad();
+        return in_view().bad();
     }
 
     [[nodiscard]] bool operator!() const
     {
-        return istream_view(m_in_out).operator!();
+        return in_view().operator!();
     }
 
     [[nodiscard]] explicit operator bool() const
     {
-        return istream_view(m_in_out).operator bool();
+        return in_view().operator bool();
     }
 
     void clear(iostate state = goodbit)
     {
-        istream_view(m_in_out).clear(state);
+        in_view().clear(state);
+    }
+
+    void setstate(iostate state)
+    {
+        in_view().setstate(state);
     }
 
     [[nodiscard]] constexpr operator istream_view() const noexcept
     {
-        return { m_in_out };
+        return in_view();
     }
 
     [[nodiscard]] constexpr operator ostream_view() const noexcept
     {
-        return { m_in_out };
+        return out_view();
+    }
+
+private:
+    [[nodiscard]] constexpr istream_view in_view() const noexcept
+    {
+        istream_view view = m_in_out ? istream_view{ m_in_out } : istream_view{ m_in_backend };
+        return view.set_byte_order(m_byte_order);
+    }
+
+    [[nodiscard]] constexpr ostream_view out_view() const noexcept
+    {
+        ostream_view view = m_in_out ? ostream_view{ m_in_out } : ostream_view{ m_out_backend };
+        return view.set_byte_order(m_byte_order);
     }
 
 private:
     std::iostream* m_in_out{ nullptr };
+    istream_backend* m_in_backend{ nullptr };
+    ostream_backend* m_out_backend{ nullptr };
+    std::endian m_byte_order{ std::endian::native };
 };
 
 } // namespace flow
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <functional>
 #include <istream>
 #include <span>
 
+#include "byteswap.hpp"
 #include "concepts.hpp"
 #include "serialization.hpp"
+#include "stream_backend.hpp"
 
 namespace flow {
 
@@ -37,6 +41,14 @@ public:
         : istream_view(&in)
     {}
 
+    constexpr istream_view(istream_backend* in) noexcept
+        : m_backend{ in }
+    {}
+
+    constexpr istream_view(istream_backend& in) noexcept
+        : istream_view(&in)
+    {}
+
     template<concepts::trivially_copyable T>
     istream_view& read(T& data)
     {
@@ -45,6 +57,25 @@ public:
             // NOLINTNEXTLINE(*-reinterpret-cast)
             m_in->read(reinterpret_cast<char*>(&data), sizeof(data));
         }
+        else if (m_backend)
+        {
+            m_backend->read(std::as_writable_bytes(std::span(&data, 1)));
+        }
+
+        if constexpr (sizeof(T) > 1)
+        {
+            if (m_byte_order != std::endian::native)
+            {
+                if constexpr (concepts::byte_order_convertible<T>)
+                {
+                    byteswap_members(data);
+                }
+                else
+                {
+                    setstate(failbit);
+                }
+            }
+        }
         return *this;
     }
 
@@ -56,6 +87,57 @@ public:
             // NOLINTNEXTLINE(*-reinterpret-cast)
             m_in->read(reinterpret_cast<char*>(span.data()), span.size_bytes());
         }
+        else if (m_backend)
+        {
+            m_backend->read(std::as_writable_bytes(span));
+        }
+
+        if constexpr (sizeof(T) > 1)
+        {
+            if (m_byte_order != std::endian::native)
+            {
+                if constexpr (concepts::byte_swappable<T>)
+                {
+                    byteswap(span);
+                }
+                else if constexpr (concepts::byte_order_convertible<T>)
+                {
+                    std::ranges::for_each(span, [](T& value) { byteswap_members(value); });
+                }
+                else
+                {
+                    setstate(failbit);
+                }
+            }
+        }
+        return *this;
+    }
+
+    // zero-copy alternative to read, only available for memory backed backends (e.g. memory_istream):
+    // points the span to the next count values in the underlying memory, or sets the failbit
+    // if the stream is not memory backed, the values are not aligned or would need byte swapping,
+    // a count past the end of the memory also sets the eofbit
+    template<concepts::trivially_copyable T>
+    istream_view& view(std::span<const T>& span, std::size_t count)
+    {
+        span = {};
+
+        if (sizeof(T) > 1 && m_byte_order != std::endian::native)
+        {
+            setstate(failbit);
+        }
+        else if (m_backend)
+        {
+            if (const std::byte* ptr = m_backend->view(count, sizeof(T), alignof(T)))
+            {
+                // NOLINTNEXTLINE(*-reinterpret-cast)
+                span = std::span(reinterpret_cast<const T*>(ptr), count);
+            }
+        }
+        else if (m_in)
+        {
+            m_in->setstate(failbit);
+        }
         return *this;
     }
 
@@ -91,6 +173,10 @@ public:
         {
             m_in->seekg(position);
         }
+        else if (m_backend)
+        {
+            m_backend->seek(position);
+        }
         return *this;
     }
 
@@ -100,32 +186,58 @@ public:
         {
             m_in->seekg(offset, direction);
         }
+        else if (m_backend)
+        {
+            m_backend->seek(offset, direction);
+        }
         return *this;
     }
 
     [[nodiscard]] pos_type tell()
     {
-        return m_in ? m_in->tellg() : pos_type{ -1 };
+        if (m_in)
+        {
+            return m_in->tellg();
+        }
+        return m_backend ? m_backend->tell() : pos_type{ -1 };
+    }
+
+    // the byte order that arithmetic and enum values are read in, see ostream_view::set_byte_order
+    // with a foreign byte order, values that are not byte_order_convertible set the failbit
+    constexpr istream_view& set_byte_order(std::endian order) noexcept
+    {
+        m_byte_order = order;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr std::endian byte_order() const noexcept
+    {
+        return m_byte_order;
+    }
+
+    [[nodiscard]] constexpr bool is_native_byte_order() const noexcept
+    {
+        return m_byte_order == std::endian::native;
     }
 
     [[nodiscard]] bool good() const
     {
-        return m_in && m_in->good();
+        return m_in ? m_in->good() : (m_backend && m_backend->good());
     }
 
     [[nodiscard]] bool eof() const
     {
-        return !m_in || m_in->eof();
+        return m_in ? m_in->eof() : (!m_backend || m_backend->eof());
     }
 
     [[nodiscard]] bool fail() const
     {
-        return !m_in || m_in->fail();
+        return m_in ? m_in->fail() : (!m_backend || m_backend->fail());
     }
 
     [[nodiscard]] bool bad() const
     {
-        return !m_in || m_in->bad();
+        return m_in ? m_in->bad() : (!m_backend || m_backend->bad());
     }
 
     [[nodiscard]] bool operator!() const
@@ -144,10 +256,28 @@ public:
         {
             m_in->clear(state);
         }
+        else if (m_backend)
+        {
+            m_backend->clear(state);
+        }
+    }
+
+    void setstate(iostate state)
+    {
+        if (m_in)
+        {
+            m_in->setstate(state);
+        }
+        else if (m_backend)
+        {
+            m_backend->setstate(state);
+        }
     }
 
 private:
     std::istream* m_in{ nullptr };
+    istream_backend* m_backend{ nullptr };
+    std::endian m_byte_order{ std::endian::native };
 };
 
 template<concepts::trivially_copyable T>
@@ -164,7 +294,7 @@ struct deserializer<std::span<T>>
 {
     void operator()(istream_view in, std::span<T> span) const
     {
-        if (concepts::trivially_copyable<T>)
+        if constexpr (concepts::trivially_copyable<T>)
         {
             in.read(span);
         }
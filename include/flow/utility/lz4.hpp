@@ -0,0 +1,308 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+
+namespace flow {
+
+// lz4 block format codec (no frame format), compatible with the reference implementation,
+// the compressor is a simple greedy hash table matcher tuned for speed over ratio
+
+namespace detail {
+
+    inline constexpr std::size_t lz4_min_match = 4;
+    inline constexpr std::size_t lz4_last_literals = 5; // the last bytes of a block are always literals
+    inline constexpr std::size_t lz4_match_find_limit = 12; // no match may start in the last bytes of a block
+    inline constexpr std::size_t lz4_max_offset = 65535;
+    inline constexpr std::size_t lz4_hash_log = 12;
+    inline constexpr std::size_t lz4_skip_trigger = 6;
+
+    [[nodiscard]] inline std::uint32_t lz4_read32(const std::byte* ptr) noexcept
+    {
+        std::uint32_t value{};
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] constexpr std::uint32_t lz4_hash(std::uint32_t sequence) noexcept
+    {
+        return (sequence * 2654435761U) >> (32 - lz4_hash_log);
+    }
+
+    // writes the extra bytes of a literal or match length that didn't fit in the token
+    [[nodiscard]] inline bool lz4_write_length(std::span<std::byte> dst, std::size_t& op, std::size_t length) noexcept
+    {
+        while (length >= 255)
+        {
+            if (op >= dst.size())
+            {
+                return false;
+            }
+
+            dst[op++] = std::byte{ 255 };
+            length -= 255;
+        }
+
+        if (op >= dst.size())
+        {
+            return false;
+        }
+
+        dst[op++] = static_cast<std::byte>(length);
+
+        return true;
+    }
+
+    [[nodiscard]] inline bool lz4_read_length(std::span<const std::byte> src, std::size_t& ip, std::size_t& length) noexcept
+    {
+        std::uint8_t byte{};
+
+        do
+        {
+            if (ip >= src.size())
+            {
+                return false;
+            }
+
+            byte = static_cast<std::uint8_t>(src[ip++]);
+            length += byte;
+        }
+        while (byte == 255);
+
+        return true;
+    }
+
+    [[nodiscard]] inline bool lz4_write_sequence(std::span<const std::byte> src,
+                                                 std::span<std::byte> dst,
+                                                 std::size_t& op,
+                                                 std::size_t literal_begin,
+                                                 std::size_t literal_count,
+                                                 std::size_t offset,
+                                                 std::size_t match_length) noexcept
+    {
+        if (op >= dst.size())
+        {
+            return false;
+        }
+
+        const std::size_t token_position = op++;
+        std::uint8_t token = 0;
+
+        if (literal_count >= 15)
+        {
+            token = 15 << 4;
+
+            if (!lz4_write_length(dst, op, literal_count - 15))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            token = static_cast<std::uint8_t>(literal_count << 4);
+        }
+
+        if (literal_count > dst.size() - op)
+        {
+            return false;
+        }
+
+        if (literal_count > 0)
+        {
+            std::memcpy(dst.data() + op, src.data() + literal_begin, literal_count);
+            op += literal_count;
+        }
+
+        // the last sequence only has literals
+        if (match_length > 0)
+        {
+            if (dst.size() - op < 2)
+            {
+                return false;
+            }
+
+            dst[op++] = static_cast<std::byte>(offset & 0xff);
+            dst[op++] = static_cast<std::byte>(offset >> 8);
+
+            const std::size_t length = match_length - lz4_min_match;
+
+            if (length >= 15)
+            {
+                token |= 15;
+
+                if (!lz4_write_length(dst, op, length - 15))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                token |= static_cast<std::uint8_t>(length);
+            }
+        }
+
+        dst[token_position] = static_cast<std::byte>(token);
+
+        return true;
+    }
+
+} // namespace detail
+
+// the largest size that compressing size bytes can produce
+[[nodiscard]] constexpr std::size_t lz4_compress_bound(std::size_t size) noexcept
+{
+    return size + size / 255 + 16;
+}
+
+// returns the compressed size, or 0 if dst is too small
+[[nodiscard]] inline std::size_t lz4_compress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept
+{
+    using namespace detail;
+
+    const std::size_t size = src.size();
+    std::size_t op = 0;
+    std::size_t anchor = 0;
+
+    if (size > lz4_match_find_limit)
+    {
+        std::array<std::uint32_t, std::size_t{ 1 } << lz4_hash_log> table{};
+
+        const std::size_t match_limit = size - lz4_last_literals;
+        const std::size_t find_limit = size - lz4_match_find_limit;
+
+        std::size_t ip = 1;
+        table[lz4_hash(lz4_read32(src.data()))] = 0;
+
+        while (ip <= find_limit)
+        {
+            const std::uint32_t sequence = lz4_read32(src.data() + ip);
+            const std::uint32_t hash = lz4_hash(sequence);
+            const std::size_t ref = table[hash];
+
+            table[hash] = static_cast<std::uint32_t>(ip);
+
+            if (ip - ref > lz4_max_offset || lz4_read32(src.data() + ref) != sequence)
+            {
+                // move faster through data that doesn't compress
+                ip += 1 + ((ip - anchor) >> lz4_skip_trigger);
+                continue;
+            }
+
+            std::size_t match_length = lz4_min_match;
+
+            while (ip + match_length < match_limit && src[ref + match_length] == src[ip + match_length])
+            {
+                ++match_length;
+            }
+
+            if (!lz4_write_sequence(src, dst, op, anchor, ip - anchor, ip - ref, match_length))
+            {
+                return 0;
+            }
+
+            ip += match_length;
+            anchor = ip;
+
+            if (ip <= find_limit)
+            {
+                table[lz4_hash(lz4_read32(src.data() + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+            }
+        }
+    }
+
+    if (!lz4_write_sequence(src, dst, op, anchor, size - anchor, 0, 0))
+    {
+        return 0;
+    }
+
+    return op;
+}
+
+// returns the decompressed size, or std::numeric_limits<std::size_t>::max() if src is
+// malformed or decompresses to more than dst can hold, never reads or writes out of bounds
+[[nodiscard]] inline std::size_t lz4_decompress(std::span<const std::byte> src, std::span<std::byte> dst) noexcept
+{
+    using namespace detail;
+
+    constexpr std::size_t error = std::numeric_limits<std::size_t>::max();
+
+    std::size_t ip = 0;
+    std::size_t op = 0;
+
+    while (ip < src.size())
+    {
+        const auto token = static_cast<std::uint8_t>(src[ip++]);
+
+        std::size_t literal_count = token >> 4;
+
+        if (literal_count == 15 && !lz4_read_length(src, ip, literal_count))
+        {
+            return error;
+        }
+
+        if (literal_count > src.size() - ip || literal_count > dst.size() - op)
+        {
+            return error;
+        }
+
+        if (literal_count > 0)
+        {
+            std::memcpy(dst.data() + op, src.data() + ip, literal_count);
+            ip += literal_count;
+            op += literal_count;
+        }
+
+        if (ip == src.size())
+        {
+            break;
+        }
+
+        if (src.size() - ip < 2)
+        {
+            return error;
+        }
+
+        const std::size_t offset = static_cast<std::size_t>(src[ip]) | (static_cast<std::size_t>(src[ip + 1]) << 8);
+        ip += 2;
+
+        std::size_t match_length = token & 15;
+
+        if (match_length == 15 && !lz4_read_length(src, ip, match_length))
+        {
+            return error;
+        }
+
+        match_length += lz4_min_match;
+
+        if (offset == 0 || offset > op || match_length > dst.size() - op)
+        {
+            return error;
+        }
+
+        std::byte* out = dst.data() + op;
+        const std::byte* match = out - offset;
+
+        if (offset >= match_length)
+        {
+            std::memcpy(out, match, match_length);
+        }
+        else
+        {
+            // overlapping matches repeat the last offset bytes
+            for (std::size_t i = 0; i < match_length; ++i)
+            {
+                out[i] = match[i];
+            }
+        }
+
+        op += match_length;
+    }
+
+    return op;
+}
+
+} // namespace flow
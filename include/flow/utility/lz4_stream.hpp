@@ -0,0 +1,431 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "istream_view.hpp"
+#include "lz4.hpp"
+#include "ostream_view.hpp"
+#include "stream_backend.hpp"
+
+namespace flow {
+
+// the compressed stream layout is
+// - the blocks, each holding block_size uncompressed bytes (except the last one),
+//   as a u32 compressed size, with the high bit set if the block is stored uncompressed,
+//   followed by the compressed bytes
+// - the offset of every block from the start of the compressed stream, as u64s
+// - a footer, which ends the underlying stream
+namespace detail {
+
+    inline constexpr std::uint32_t lz4_stream_magic = 0x5a4c4c46; // "FLLZ"
+    inline constexpr std::uint32_t lz4_stored_block_flag = 0x80000000;
+
+    // bounds the buffers a reader allocates for the blocks of a stream it hasn't checked yet
+    inline constexpr std::uint32_t lz4_max_block_size = 1 << 24;
+
+    struct lz4_stream_footer
+    {
+        std::uint64_t uncompressed_size;
+        std::uint64_t index_offset; // from the start of the compressed stream
+        std::uint32_t block_size;
+        std::uint32_t block_count;
+        std::uint32_t magic;
+        std::uint32_t reserved;
+    };
+
+} // namespace detail
+
+// output stream backend that compresses everything written to it in fixed size blocks
+// and writes them to another stream, it can only write sequentially
+class lz4_ostream final : public ostream_backend
+{
+public:
+    static constexpr std::size_t default_block_size = 1 << 16;
+    static constexpr std::size_t max_block_size = detail::lz4_max_block_size;
+
+public:
+    lz4_ostream() noexcept = default;
+
+    explicit lz4_ostream(ostream_view out, std::size_t block_size = default_block_size)
+    {
+        open(out, block_size);
+    }
+
+    ~lz4_ostream() override
+    {
+        close();
+    }
+
+    bool open(ostream_view out, std::size_t block_size = default_block_size)
+    {
+        close();
+
+        m_out = out;
+        m_start_position = out.tell();
+        m_block_offsets.clear();
+        m_uncompressed_size = 0;
+        m_block.resize(std::clamp<std::size_t>(block_size, 1, max_block_size));
+        m_compressed.resize(lz4_compress_bound(m_block.size()));
+        m_open = static_cast<bool>(out);
+
+        set_put_area(m_block.data(), m_block.data() + m_block.size());
+        clear();
+
+        return m_open;
+    }
+
+    // compresses the buffered bytes and writes the block index and the footer,
+    // nothing can be written to the underlying stream after the compressed stream
+    bool close()
+    {
+        if (!m_open)
+        {
+            return true;
+        }
+
+        m_open = false;
+
+        const bool written = write_block() && write_index();
+
+        set_put_area(nullptr, nullptr);
+
+        return written;
+    }
+
+    [[nodiscard]] constexpr bool is_open() const noexcept
+    {
+        return m_open;
+    }
+
+private:
+    std::size_t do_write(std::span<const std::byte> bytes) override
+    {
+        if (!m_open)
+        {
+            return 0;
+        }
+
+        std::size_t count = 0;
+
+        while (count < bytes.size())
+        {
+            const auto available = static_cast<std::size_t>(put_end() - put_current());
+            const std::size_t chunk = std::min(available, bytes.size() - count);
+
+            std::memcpy(put_current(), bytes.data() + count, chunk);
+            set_put_area(put_current() + chunk, put_end());
+            count += chunk;
+
+            if (put_current() == put_end() && !write_block())
+            {
+                return count;
+            }
+        }
+
+        return count;
+    }
+
+    bool do_seekp(off_type offset, seekdir direction) override
+    {
+        // only the current position can be sought to
+        return (direction == current && offset == 0)
+            || (direction == begin && offset == static_cast<off_type>(position()));
+    }
+
+    [[nodiscard]] pos_type do_tellp() override
+    {
+        return pos_type{ static_cast<off_type>(position()) };
+    }
+
+    bool do_flush() override
+    {
+        m_out.flush();
+        return static_cast<bool>(m_out);
+    }
+
+    [[nodiscard]] std::uint64_t position() const noexcept
+    {
+        return m_uncompressed_size + static_cast<std::uint64_t>(put_current() - m_block.data());
+    }
+
+    bool write_block()
+    {
+        const auto size = static_cast<std::size_t>(put_current() - m_block.data());
+
+        if (size == 0)
+        {
+            return true;
+        }
+
+        const std::span<const std::byte> block = std::span(m_block).first(size);
+        const std::size_t compressed_size = lz4_compress(block, m_compressed);
+
+        m_block_offsets.push_back(static_cast<std::uint64_t>(m_out.tell() - m_start_position));
+
+        if (compressed_size == 0 || compressed_size >= size)
+        {
+            m_out.write(static_cast<std::uint32_t>(size) | detail::lz4_stored_block_flag).write(block);
+        }
+        else
+        {
+            m_out.write(static_cast<std::uint32_t>(compressed_size))
+                .write(std::span<const std::byte>(m_compressed).first(compressed_size));
+        }
+
+        m_uncompressed_size += size;
+        set_put_area(m_block.data(), m_block.data() + m_block.size());
+
+        return static_cast<bool>(m_out);
+    }
+
+    bool write_index()
+    {
+        const detail::lz4_stream_footer footer{
+            .uncompressed_size = m_uncompressed_size,
+            .index_offset = static_cast<std::uint64_t>(m_out.tell() - m_start_position),
+            .block_size = static_cast<std::uint32_t>(m_block.size()),
+            .block_count = static_cast<std::uint32_t>(m_block_offsets.size()),
+            .magic = detail::lz4_stream_magic,
+            .reserved = 0,
+        };
+
+        m_out.write(std::span<const std::uint64_t>(m_block_offsets)).write(footer).flush();
+
+        return static_cast<bool>(m_out);
+    }
+
+private:
+    ostream_view m_out{};
+    pos_type m_start_position{};
+    std::vector<std::byte> m_block{};
+    std::vector<std::byte> m_compressed{};
+    std::vector<std::uint64_t> m_block_offsets{};
+    std::uint64_t m_uncompressed_size{};
+    bool m_open{ false };
+};
+
+// input stream backend that decompresses a stream written by lz4_ostream,
+// which must end the underlying stream, one block at a time
+// seeking to any position only decompresses the block that contains it
+class lz4_istream final : public istream_backend
+{
+public:
+    lz4_istream() noexcept = default;
+
+    explicit lz4_istream(istream_view in)
+    {
+        open(in);
+    }
+
+    bool open(istream_view in)
+    {
+        m_in = in;
+        m_block_offsets.clear();
+        m_loaded_block = no_block;
+        m_uncompressed_size = 0;
+
+        set_get_area(nullptr, nullptr);
+        clear();
+
+        detail::lz4_stream_footer footer{};
+        in.seek(-static_cast<off_type>(sizeof(footer)), end);
+        const pos_type footer_position = in.tell();
+        in.read(footer);
+
+        if (!in || !is_valid(footer, static_cast<std::uint64_t>(static_cast<off_type>(footer_position))))
+        {
+            setstate(failbit);
+            return false;
+        }
+
+        const auto index_size = static_cast<off_type>(std::uint64_t{ footer.block_count } * sizeof(std::uint64_t));
+        const pos_type index_position = footer_position - index_size;
+
+        m_start_position = index_position - static_cast<off_type>(footer.index_offset);
+        m_uncompressed_size = footer.uncompressed_size;
+        m_block_offsets.resize(footer.block_count);
+        m_block.resize(footer.block_size);
+        m_compressed.resize(lz4_compress_bound(footer.block_size));
+
+        in.seek(index_position).read(std::span(m_block_offsets));
+
+        if (!in)
+        {
+            setstate(failbit);
+            return false;
+        }
+
+        if (!m_block_offsets.empty() && !load_block(0))
+        {
+            setstate(failbit);
+            return false;
+        }
+
+        return true;
+    }
+
+    // the size of the decompressed stream
+    [[nodiscard]] constexpr std::uint64_t size() const noexcept
+    {
+        return m_uncompressed_size;
+    }
+
+private:
+    static constexpr std::size_t no_block = std::numeric_limits<std::size_t>::max();
+
+    // the footer is checked before anything is allocated for it, the index and the blocks must
+    // fit in front of it, at footer_position, and the blocks must hold the uncompressed bytes
+    [[nodiscard]] static bool is_valid(const detail::lz4_stream_footer& footer, std::uint64_t footer_position) noexcept
+    {
+        if (footer.magic != detail::lz4_stream_magic || footer.block_size == 0
+            || footer.block_size > detail::lz4_max_block_size)
+        {
+            return false;
+        }
+
+        const std::uint64_t index_size = std::uint64_t{ footer.block_count } * sizeof(std::uint64_t);
+        const std::uint64_t block_count = footer.uncompressed_size / footer.block_size
+                                        + (footer.uncompressed_size % footer.block_size != 0 ? 1 : 0);
+
+        return index_size <= footer_position && footer.index_offset <= footer_position - index_size
+            && block_count == footer.block_count;
+    }
+
+    std::size_t do_read(std::span<std::byte> bytes) override
+    {
+        std::size_t count = 0;
+
+        while (count < bytes.size())
+        {
+            const auto available = static_cast<std::size_t>(get_end() - get_current());
+
+            if (available == 0)
+            {
+                if (m_loaded_block == no_block || !load_block(m_loaded_block + 1))
+                {
+                    break;
+                }
+
+                continue;
+            }
+
+            const std::size_t chunk = std::min(available, bytes.size() - count);
+
+            std::memcpy(bytes.data() + count, get_current(), chunk);
+            set_get_area(get_current() + chunk, get_end());
+            count += chunk;
+        }
+
+        return count;
+    }
+
+    bool do_seekg(off_type offset, seekdir direction) override
+    {
+        off_type base{};
+
+        switch (direction)
+        {
+            case begin:   base = 0; break;
+            case current: base = static_cast<off_type>(position()); break;
+            case end:     base = static_cast<off_type>(m_uncompressed_size); break;
+            default:      return false;
+        }
+
+        const off_type target = base + offset;
+
+        if (target < 0 || static_cast<std::uint64_t>(target) > m_uncompressed_size)
+        {
+            return false;
+        }
+
+        if (m_block_offsets.empty())
+        {
+            return true;
+        }
+
+        // the end of the stream is the end of the last block
+        const auto target_position = static_cast<std::uint64_t>(target);
+        const std::size_t block = std::min<std::size_t>(target_position / m_block.size(), m_block_offsets.size() - 1);
+
+        if (block != m_loaded_block && !load_block(block))
+        {
+            return false;
+        }
+
+        set_get_area(m_block.data() + (target_position - block * m_block.size()), get_end());
+
+        return true;
+    }
+
+    [[nodiscard]] pos_type do_tellg() override
+    {
+        return pos_type{ static_cast<off_type>(position()) };
+    }
+
+    [[nodiscard]] std::uint64_t position() const noexcept
+    {
+        if (m_loaded_block == no_block)
+        {
+            return 0;
+        }
+
+        return m_loaded_block * m_block.size() + static_cast<std::uint64_t>(get_current() - m_block.data());
+    }
+
+    bool load_block(std::size_t block)
+    {
+        if (block >= m_block_offsets.size())
+        {
+            return false;
+        }
+
+        std::uint32_t header{};
+        m_in.seek(m_start_position + static_cast<off_type>(m_block_offsets[block])).read(header);
+
+        const std::size_t expected_size = std::min<std::uint64_t>(m_block.size(),
+                                                                  m_uncompressed_size - block * m_block.size());
+        const std::size_t stored_size = header & ~detail::lz4_stored_block_flag;
+
+        std::size_t size = 0;
+
+        if ((header & detail::lz4_stored_block_flag) != 0)
+        {
+            size = stored_size <= m_block.size() ? stored_size : 0;
+            m_in.read(std::span(m_block).first(size));
+        }
+        else if (stored_size <= m_compressed.size())
+        {
+            m_in.read(std::span(m_compressed).first(stored_size));
+            size = lz4_decompress(std::span<const std::byte>(m_compressed).first(stored_size), m_block);
+        }
+
+        if (!m_in || size != expected_size)
+        {
+            m_loaded_block = no_block;
+            set_get_area(nullptr, nullptr);
+            return false;
+        }
+
+        m_loaded_block = block;
+        set_get_area(m_block.data(), m_block.data() + size);
+
+        return true;
+    }
+
+private:
+    istream_view m_in{};
+    pos_type m_start_position{};
+    std::vector<std::byte> m_block{};
+    std::vector<std::byte> m_compressed{};
+    std::vector<std::uint64_t> m_block_offsets{};
+    std::uint64_t m_uncompressed_size{};
+    std::size_t m_loaded_block{ no_block };
+};
+
+} // namespace flow
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <utility>
+
+namespace flow {
+
+// expected access pattern of a range of a mapped_file, see mapped_file::advise
+enum class mapped_file_advice : std::uint8_t
+{
+    normal,
+    sequential,
+    random,
+    will_need,
+    dont_need,
+};
+
+// read-only memory mapping of a whole file, pages are loaded lazily by the os
+// when they are first accessed, so opening is O(1) regardless of the file size
+// an empty file can't be mapped, it is open with an empty span of bytes
+class mapped_file
+{
+public:
+    constexpr mapped_file() noexcept = default;
+
+    explicit mapped_file(const std::filesystem::path& path) noexcept
+    {
+        open(path);
+    }
+
+    mapped_file(const mapped_file& other) = delete;
+    mapped_file& operator=(const mapped_file& other) = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+        : m_data{ std::exchange(other.m_data, nullptr) }
+        , m_size{ std::exchange(other.m_size, 0) }
+        , m_is_open{ std::exchange(other.m_is_open, false) }
+    {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_is_open = std::exchange(other.m_is_open, false);
+        }
+
+        return *this;
+    }
+
+    ~mapped_file() noexcept
+    {
+        close();
+    }
+
+    bool open(const std::filesystem::path& path) noexcept;
+
+    void close() noexcept;
+
+    // hints the os about how the bytes in [offset, offset + size) will be accessed,
+    // e.g. will_need starts reading them in the background, the range is clamped to the file
+    // returns false if the hint is not supported or failed, which is otherwise harmless
+    bool advise(std::size_t offset, std::size_t size, mapped_file_advice advice) const noexcept;
+
+    [[nodiscard]] constexpr std::span<const std::byte> bytes() const noexcept
+    {
+        return { m_data, m_size };
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr bool is_open() const noexcept
+    {
+        return m_is_open;
+    }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return is_open();
+    }
+
+private:
+    const std::byte* m_data{ nullptr };
+    std::size_t m_size{};
+    bool m_is_open{ false };
+};
+
+} // namespace flow
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "../core/assertion.hpp"
+#include "concepts.hpp"
+#include "mapped_file.hpp"
+#include "sliding_window.hpp"
+
+namespace flow {
+
+// read-only counterpart of sliding_stream_buffer over a mapped_file
+// values() points directly into the mapping, so loading a window only moves the span,
+// and the os is asked to start reading the next window in the direction of travel
+template<concepts::trivially_copyable T, std::unsigned_integral SizeT = std::size_t>
+class mapped_sliding_buffer
+{
+public:
+    using value_type = T;
+    using size_type = SizeT;
+
+private:
+    enum class travel_direction : std::uint8_t
+    {
+        none,
+        forward,
+        backward,
+    };
+
+public:
+    constexpr mapped_sliding_buffer() noexcept = default;
+
+    mapped_sliding_buffer(const mapped_file& file,
+                          size_type stream_start_position,
+                          size_type element_count,
+                          size_type buffer_element_count)
+    {
+        create(file, stream_start_position, element_count, buffer_element_count);
+    }
+
+    mapped_sliding_buffer(const mapped_file& file,
+                          size_type stream_start_position,
+                          size_type element_count,
+                          size_type buffer_element_count,
+                          size_type buffer_begin_index)
+    {
+        create(file, stream_start_position, element_count, buffer_element_count, buffer_begin_index);
+    }
+
+    void create(const mapped_file& file,
+                size_type stream_start_position,
+                size_type element_count,
+                size_type buffer_element_count)
+    {
+        create(file,
+               stream_start_position,
+               sliding_window(size_type{ 0 }, element_count, buffer_element_count));
+    }
+
+    void create(const mapped_file& file,
+                size_type stream_start_position,
+                size_type element_count,
+                size_type buffer_element_count,
+                size_type buffer_begin_index)
+    {
+        create(file,
+               stream_start_position,
+               sliding_window(size_type{ 0 }, element_count, buffer_element_count, buffer_begin_index));
+    }
+
+    constexpr size_type forward(size_type count) noexcept
+    {
+        m_direction = travel_direction::forward;
+        return m_sliding_window.forward(count);
+    }
+
+    constexpr size_type backward(size_type count) noexcept
+    {
+        m_direction = travel_direction::backward;
+        return m_sliding_window.backward(count);
+    }
+
+    constexpr size_type forward_inc(size_type count) noexcept
+    {
+        m_direction = travel_direction::forward;
+        return m_sliding_window.forward_inc(count);
+    }
+
+    constexpr size_type backward_dec(size_type count) noexcept
+    {
+        m_direction = travel_direction::backward;
+        return m_sliding_window.backward_dec(count);
+    }
+
+    constexpr void set_begin(size_type position) noexcept
+    {
+        if (position != begin())
+        {
+            m_direction = position > begin() ? travel_direction::forward : travel_direction::backward;
+        }
+
+        m_sliding_window.seek(position);
+    }
+
+    [[nodiscard]] constexpr size_type begin() const noexcept
+    {
+        return m_sliding_window.begin();
+    }
+
+    [[nodiscard]] constexpr size_type end() const noexcept
+    {
+        return m_sliding_window.end();
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return m_sliding_window.size();
+    }
+
+    [[nodiscard]] constexpr size_type loaded_size() const noexcept
+    {
+        return static_cast<size_type>(m_values.size());
+    }
+
+    [[nodiscard]] constexpr size_type bounds_begin() const noexcept
+    {
+        return m_sliding_window.bounds_begin();
+    }
+
+    [[nodiscard]] constexpr size_type bounds_end() const noexcept
+    {
+        return m_sliding_window.bounds_end();
+    }
+
+    [[nodiscard]] constexpr size_type bounds_size() const noexcept
+    {
+        return m_sliding_window.bounds_size();
+    }
+
+    [[nodiscard]] constexpr size_type stream_begin() const noexcept
+    {
+        return m_stream_start_position + begin() * sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type stream_end() const noexcept
+    {
+        return m_stream_start_position + end() * sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type stream_size() const noexcept
+    {
+        return size() * sizeof(value_type);
+    }
+
+    [[nodiscard]] constexpr size_type stream_bounds_begin() const noexcept
+    {
+        return m_stream_start_position;
+    }
+
+    [[nodiscard]] constexpr size_type stream_bounds_end() const noexcept
+    {
+        return m_stream_start_position + stream_bounds_size();
+    }
+
+    [[nodiscard]] constexpr size_type stream_bounds_size() const noexcept
+    {
+        return bounds_size() * sizeof(value_type);
+    }
+
+    // the values of the window that was last loaded, valid while the mapped_file is open
+    [[nodiscard]] constexpr std::span<const value_type> values() const noexcept
+    {
+        return m_values;
+    }
+
+    constexpr void resize(size_type size) noexcept
+    {
+        m_sliding_window.resize(size);
+    }
+
+    // O(1), the pages of the window are read by the os when they are first accessed,
+    // the values past the end of the file are not part of the loaded window
+    void load()
+    {
+        FLOW_ASSERT(m_file && m_file->is_open(), "the mapped file is not open");
+
+        const std::span<const std::byte> bytes = m_file->bytes();
+        const std::size_t first = std::min<std::size_t>(stream_begin(), bytes.size());
+        const std::size_t last = std::min<std::size_t>(stream_end(), bytes.size());
+
+        m_values = std::span(
+            // NOLINTNEXTLINE(*-reinterpret-cast)
+            reinterpret_cast<const value_type*>(bytes.data() + first),
+            (last - first) / sizeof(value_type));
+
+        prefetch();
+    }
+
+private:
+    void create(const mapped_file& file, size_type stream_start_position, const sliding_window<size_type>& window)
+    {
+        // the mapping is page aligned, so only the start position can misalign the values
+        FLOW_ASSERT(stream_start_position % alignof(value_type) == 0, "the values are not suitably aligned");
+
+        m_file = &file;
+        m_stream_start_position = stream_start_position;
+        m_sliding_window = window;
+        m_values = {};
+        m_direction = travel_direction::none;
+    }
+
+    // asks the os to read the window that follows in the direction of travel
+    void prefetch() const
+    {
+        switch (m_direction)
+        {
+            case travel_direction::forward:
+            {
+                m_file->advise(stream_end(), stream_size(), mapped_file_advice::will_need);
+                break;
+            }
+            case travel_direction::backward:
+            {
+                const size_type size = std::min(stream_size(), stream_begin() - stream_bounds_begin());
+                m_file->advise(stream_begin() - size, size, mapped_file_advice::will_need);
+                break;
+            }
+            default: break;
+        }
+    }
+
+private:
+    const mapped_file* m_file{ nullptr };
+    std::span<const value_type> m_values{};
+    sliding_window<size_type> m_sliding_window{};
+    size_type m_stream_start_position{};
+    travel_direction m_direction{ travel_direction::none };
+};
+
+} // namespace flow
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "stream_backend.hpp"
+
+namespace flow {
+
+// input stream backend over a contiguous block of memory (e.g. a mapped file),
+// the whole block is the get area, so every read is a plain memcpy, and it can also
+// hand out pointers into the underlying memory instead of copying from it
+class memory_istream final : public istream_backend
+{
+public:
+    memory_istream() noexcept = default;
+
+    memory_istream(std::span<const std::byte> data) noexcept
+        : m_data{ data }
+    {
+        set_get_area(m_data.data(), m_data.data() + m_data.size());
+    }
+
+    [[nodiscard]] constexpr std::span<const std::byte> data() const noexcept
+    {
+        return m_data;
+    }
+
+private:
+    std::size_t do_read(std::span<std::byte> bytes) override
+    {
+        const auto count = static_cast<std::size_t>(get_end() - get_current());
+
+        if (count > 0)
+        {
+            std::memcpy(bytes.data(), get_current(), count);
+        }
+
+        set_get_area(get_end(), get_end());
+
+        return count;
+    }
+
+    bool do_seekg(off_type offset, seekdir direction) override
+    {
+        off_type base{};
+
+        switch (direction)
+        {
+            case begin:   base = 0; break;
+            case current: base = static_cast<off_type>(position()); break;
+            case end:     base = static_cast<off_type>(m_data.size()); break;
+            default:      return false;
+        }
+
+        const off_type target = base + offset;
+
+        if (target < 0 || target > static_cast<off_type>(m_data.size()))
+        {
+            return false;
+        }
+
+        set_get_area(m_data.data() + target, get_end());
+
+        return true;
+    }
+
+    [[nodiscard]] pos_type do_tellg() override
+    {
+        return pos_type{ static_cast<off_type>(position()) };
+    }
+
+    [[nodiscard]] const std::byte* do_view(std::size_t count, std::size_t size, std::size_t alignment) override
+    {
+        const std::byte* ptr = get_current();
+
+        if (count > static_cast<std::size_t>(get_end() - ptr) / size)
+        {
+            setstate(eofbit);
+            return nullptr;
+        }
+
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        if (reinterpret_cast<std::uintptr_t>(ptr) % alignment != 0)
+        {
+            return nullptr;
+        }
+
+        set_get_area(ptr + count * size, get_end());
+
+        return ptr;
+    }
+
+    [[nodiscard]] std::size_t position() const noexcept
+    {
+        return static_cast<std::size_t>(get_current() - m_data.data());
+    }
+
+private:
+    std::span<const std::byte> m_data{};
+};
+
+} // namespace flow
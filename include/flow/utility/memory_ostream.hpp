@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include "stream_backend.hpp"
+
+namespace flow {
+
+// output stream backend over a fixed block of writable memory,
+// writes past the end of the block write what fits and set the badbit
+class memory_ostream final : public ostream_backend
+{
+public:
+    memory_ostream() noexcept = default;
+
+    memory_ostream(std::span<std::byte> data) noexcept
+        : m_data{ data }
+    {
+        set_put_area(m_data.data(), m_data.data() + m_data.size());
+    }
+
+    // the bytes up to the furthest position that was written to or seeked past
+    [[nodiscard]] std::span<std::byte> written() const noexcept
+    {
+        return m_data.first(std::max(m_size, position()));
+    }
+
+    [[nodiscard]] constexpr std::span<std::byte> data() const noexcept
+    {
+        return m_data;
+    }
+
+private:
+    std::size_t do_write(std::span<const std::byte> bytes) override
+    {
+        const auto count = static_cast<std::size_t>(put_end() - put_current());
+
+        if (count > 0)
+        {
+            std::memcpy(put_current(), bytes.data(), count);
+        }
+
+        set_put_area(put_end(), put_end());
+
+        return count;
+    }
+
+    bool do_seekp(off_type offset, seekdir direction) override
+    {
+        off_type base{};
+
+        switch (direction)
+        {
+            case begin:   base = 0; break;
+            case current: base = static_cast<off_type>(position()); break;
+            case end:     base = static_cast<off_type>(std::max(m_size, position())); break;
+            default:      return false;
+        }
+
+        const off_type target = base + offset;
+
+        if (target < 0 || target > static_cast<off_type>(m_data.size()))
+        {
+            return false;
+        }
+
+        m_size = std::max(m_size, position());
+        set_put_area(m_data.data() + target, put_end());
+
+        return true;
+    }
+
+    [[nodiscard]] pos_type do_tellp() override
+    {
+        return pos_type{ static_cast<off_type>(position()) };
+    }
+
+    [[nodiscard]] std::size_t position() const noexcept
+    {
+        return static_cast<std::size_t>(put_current() - m_data.data());
+    }
+
+private:
+    std::span<std::byte> m_data{};
+    std::size_t m_size{};
+};
+
+} // namespace flow
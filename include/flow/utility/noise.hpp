@@ -5,25 +5,34 @@
 #include <cstddef>
 #include <cstdint>
 #include <numeric>
+#include <span>
 #include <utility>
 #include <vector>
 
 #include <glm/common.hpp>
 #include <glm/geometric.hpp>
 #include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
+#include "../core/assertion.hpp"
+#include "fixed_point.hpp"
 #include "random.hpp"
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#endif
+
 namespace flow {
 namespace detail {
 
     template<std::size_t N, typename T>
-    using gradient_type = glm::vec<2, T, glm::packed_highp>;
+    using gradient_type = glm::vec<N, T, glm::packed_highp>;
 
     template<std::size_t N, typename T>
     struct lattice_point
     {
-        using gradient_type = gradient_type<N, T>;
+        using offset_type = gradient_type<N, T>;
         using point_type = glm::vec<N, int, glm::packed_highp>;
 
         constexpr lattice_point(int x, int y) noexcept
@@ -32,7 +41,7 @@ namespace detail {
             , d{}
         {
             T ssv = static_cast<T>(sv.x + sv.y) * static_cast<T>(-0.211324865405187);
-            d = -(gradient_type(sv) + ssv);
+            d = -(offset_type(sv) + ssv);
         }
 
         constexpr lattice_point(point_type point) noexcept
@@ -41,7 +50,7 @@ namespace detail {
         {}
 
         point_type sv;
-        gradient_type d;
+        offset_type d;
     };
 
     template<std::size_t N, typename T>
@@ -50,6 +59,12 @@ namespace detail {
     template<typename T>
     inline constexpr T GradParam<2, T> = static_cast<T>(0.01001634121365712);
 
+    template<typename T>
+    inline constexpr T GradParam<3, T> = static_cast<T>(0.07969837668935331);
+
+    template<typename T>
+    inline constexpr T GradParam<4, T> = static_cast<T>(0.0220065933241897);
+
     template<std::size_t N, typename T>
     inline constexpr std::array<gradient_type<N, T>, 1> gradient_samples{};
 
@@ -85,6 +100,96 @@ namespace detail {
         // clang-format on
     };
 
+    template<typename T>
+    inline constexpr std::array gradient_samples<3, T> = {
+        // clang-format off
+
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>( 2.22474487139      ), static_cast<T>(-1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>( 2.22474487139      ), static_cast<T>( 1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 3.0862664687972017 ), static_cast<T>( 1.1721513422464978 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.1721513422464978 ), static_cast<T>( 3.0862664687972017 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>( 2.22474487139      ), static_cast<T>(-1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>( 2.22474487139      ), static_cast<T>( 1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.1721513422464978 ), static_cast<T>( 3.0862664687972017 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-3.0862664687972017 ), static_cast<T>( 1.1721513422464978 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.0                ), static_cast<T>(-2.22474487139      ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.0                ), static_cast<T>(-2.22474487139      ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>(-3.0862664687972017 ), static_cast<T>(-1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>(-1.1721513422464978 ), static_cast<T>(-3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.0                ), static_cast<T>(-2.22474487139      ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.0                ), static_cast<T>(-2.22474487139      ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>(-1.1721513422464978 ), static_cast<T>( 3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>(-3.0862664687972017 ), static_cast<T>( 1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>(-2.22474487139      ), static_cast<T>(-1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>(-2.22474487139      ), static_cast<T>( 1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-3.0862664687972017 ), static_cast<T>(-1.1721513422464978 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.1721513422464978 ), static_cast<T>(-3.0862664687972017 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>(-1.0                ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>( 1.0                ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.1721513422464978 ), static_cast<T>( 0.0                ), static_cast<T>(-3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-3.0862664687972017 ), static_cast<T>( 0.0                ), static_cast<T>(-1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>(-1.0                ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-2.22474487139      ), static_cast<T>( 1.0                ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-3.0862664687972017 ), static_cast<T>( 0.0                ), static_cast<T>( 1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.1721513422464978 ), static_cast<T>( 0.0                ), static_cast<T>( 3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.0                ), static_cast<T>( 2.22474487139      ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.0                ), static_cast<T>( 2.22474487139      ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>( 1.1721513422464978 ), static_cast<T>(-3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>( 3.0862664687972017 ), static_cast<T>(-1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>(-1.0                ), static_cast<T>( 2.22474487139      ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.0                ), static_cast<T>( 2.22474487139      ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>( 3.0862664687972017 ), static_cast<T>( 1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 0.0                ), static_cast<T>( 1.1721513422464978 ), static_cast<T>( 3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>(-2.22474487139      ), static_cast<T>(-1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>(-2.22474487139      ), static_cast<T>( 1.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.1721513422464978 ), static_cast<T>(-3.0862664687972017 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 3.0862664687972017 ), static_cast<T>(-1.1721513422464978 ), static_cast<T>( 0.0                ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>(-1.0                ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>( 1.0                ), static_cast<T>(-2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 3.0862664687972017 ), static_cast<T>( 0.0                ), static_cast<T>(-1.1721513422464978 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.1721513422464978 ), static_cast<T>( 0.0                ), static_cast<T>(-3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>(-1.0                ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 2.22474487139      ), static_cast<T>( 1.0                ), static_cast<T>( 2.22474487139      ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 1.1721513422464978 ), static_cast<T>( 0.0                ), static_cast<T>( 3.0862664687972017 ) } / GradParam<3, T>,
+        gradient_type<3, T>{ static_cast<T>( 3.0862664687972017 ), static_cast<T>( 0.0                ), static_cast<T>( 1.1721513422464978 ) } / GradParam<3, T>
+
+        // clang-format on
+    };
+
+    // the 32 midpoints of the edges of the tesseract, (0, +-1, +-1, +-1) in every order, normalized
+    template<typename T>
+    [[nodiscard]] consteval std::array<gradient_type<4, T>, 32> generate_gradient_samples_4d() noexcept
+    {
+        constexpr T length = static_cast<T>(1.7320508075688772);
+
+        std::array<gradient_type<4, T>, 32> samples{};
+        std::size_t index = 0;
+
+        for (std::size_t zero = 0; zero < 4; ++zero)
+        {
+            for (std::size_t signs = 0; signs < 8; ++signs)
+            {
+                gradient_type<4, T> sample{};
+                std::size_t bit = 0;
+
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    if (i != zero)
+                    {
+                        sample[static_cast<glm::length_t>(i)] = ((signs >> bit++) & 1) != 0 ? static_cast<T>(-1) : static_cast<T>(1);
+                    }
+                }
+
+                samples[index++] = sample / length / GradParam<4, T>;
+            }
+        }
+
+        return samples;
+    }
+
+    template<typename T>
+    inline constexpr std::array gradient_samples<4, T> = generate_gradient_samples_4d<T>();
+
     template<std::size_t N, typename T>
     inline constexpr std::array<lattice_point<N, T>, 1> lattice_points{};
 
@@ -113,13 +218,172 @@ namespace detail {
         return gradients;
     }
 
+    template<std::size_t N>
+    using fixed_gradient_type = glm::vec<N, std::int16_t, glm::packed_highp>;
+
+    inline constexpr std::size_t fixed_gradient_fraction_bit_count = 8;
+    // the most that keeps (x + y) * constant in 64 bits over the whole 16.16 range
+    inline constexpr std::size_t fixed_constant_fraction_bit_count = 30;
+
+    [[nodiscard]] consteval std::int64_t to_fixed_constant(double value) noexcept
+    {
+        value *= static_cast<double>(std::int64_t{ 1 } << fixed_constant_fraction_bit_count);
+        return static_cast<std::int64_t>(value < 0 ? value - 0.5 : value + 0.5);
+    }
+
+    struct fixed_lattice_point
+    {
+        int x;
+        int y;
+        std::int64_t d_x;
+        std::int64_t d_y;
+    };
+
+    template<std::size_t FractionBitCount>
+    [[nodiscard]] consteval fixed_lattice_point make_fixed_lattice_point(int x, int y) noexcept
+    {
+        const std::int64_t ssv = ((x + y) * to_fixed_constant(-0.211324865405187))
+                              >> (fixed_constant_fraction_bit_count - FractionBitCount);
+
+        return { x, y, -((std::int64_t{ x } << FractionBitCount) + ssv), -((std::int64_t{ y } << FractionBitCount) + ssv) };
+    }
+
+    template<std::size_t FractionBitCount>
+    inline constexpr std::array fixed_lattice_points = {
+        make_fixed_lattice_point<FractionBitCount>(1, 0),
+        make_fixed_lattice_point<FractionBitCount>(0, 0),
+        make_fixed_lattice_point<FractionBitCount>(1, 1),
+        make_fixed_lattice_point<FractionBitCount>(0, 1),
+    };
+
+    // the gradients of the fixed point noise, already divided by GradParam, as 8 bit fractions
+    template<std::size_t N, std::size_t PermN>
+    [[nodiscard]] consteval std::array<fixed_gradient_type<N>, PermN> generate_fixed_gradients() noexcept
+    {
+        constexpr double scale = 1 << fixed_gradient_fraction_bit_count;
+
+        std::array<fixed_gradient_type<N>, PermN> gradients{};
+
+        for (std::size_t i = 0; i < gradients.size(); ++i)
+        {
+            const gradient_type<N, double>& sample = gradient_samples<N, double>[i % gradient_samples<N, double>.size()];
+
+            for (glm::length_t k = 0; k < static_cast<glm::length_t>(N); ++k)
+            {
+                const double value = sample[k] * scale;
+                gradients[i][k] = static_cast<std::int16_t>(value < 0 ? value - 0.5 : value + 0.5);
+            }
+        }
+
+        return gradients;
+    }
+
+#if defined(__AVX2__)
+    // the avx2 operations used by the batched open_simplex kernel, for float and double
+    template<typename T>
+    struct open_simplex_simd;
+
+    template<>
+    struct open_simplex_simd<float>
+    {
+        using vector_type = __m256;
+        using index_type = __m256i;
+
+        static constexpr std::size_t width = 8;
+
+        // NOLINTBEGIN(*-reinterpret-cast)
+        static vector_type load(const float* ptr) noexcept { return _mm256_loadu_ps(ptr); }
+        static void store(float* ptr, vector_type v) noexcept { _mm256_storeu_ps(ptr, v); }
+        static vector_type set(float value) noexcept { return _mm256_set1_ps(value); }
+        static vector_type add(vector_type a, vector_type b) noexcept { return _mm256_add_ps(a, b); }
+        static vector_type sub(vector_type a, vector_type b) noexcept { return _mm256_sub_ps(a, b); }
+        static vector_type mul(vector_type a, vector_type b) noexcept { return _mm256_mul_ps(a, b); }
+        static vector_type max(vector_type a, vector_type b) noexcept { return _mm256_max_ps(a, b); }
+        static vector_type floor(vector_type v) noexcept { return _mm256_floor_ps(v); }
+        static vector_type greater_equal(vector_type a, vector_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static vector_type select(vector_type mask, vector_type a, vector_type b) noexcept { return _mm256_blendv_ps(b, a, mask); }
+        static index_type to_index(vector_type v) noexcept { return _mm256_cvttps_epi32(v); }
+        static index_type set_index(int value) noexcept { return _mm256_set1_epi32(value); }
+        static index_type add(index_type a, index_type b) noexcept { return _mm256_add_epi32(a, b); }
+        static index_type bit_and(index_type a, index_type b) noexcept { return _mm256_and_si256(a, b); }
+        static index_type bit_xor(index_type a, index_type b) noexcept { return _mm256_xor_si256(a, b); }
+        static index_type select(vector_type mask, index_type a, index_type b) noexcept
+        {
+            return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), mask));
+        }
+
+        // gathers the 16 bit values at the indices, reads the 2 bytes that follow the last one
+        static index_type gather(const std::int16_t* ptr, index_type indices) noexcept
+        {
+            const index_type values = _mm256_i32gather_epi32(reinterpret_cast<const int*>(ptr), indices, 2);
+            return _mm256_srai_epi32(_mm256_slli_epi32(values, 16), 16);
+        }
+
+        // gathers the component of the 2d vectors at the indices
+        static vector_type gather(const float* ptr, index_type indices) noexcept
+        {
+            return _mm256_i32gather_ps(ptr, _mm256_slli_epi32(indices, 1), 4);
+        }
+        // NOLINTEND(*-reinterpret-cast)
+    };
+
+    template<>
+    struct open_simplex_simd<double>
+    {
+        using vector_type = __m256d;
+        using index_type = __m128i;
+
+        static constexpr std::size_t width = 4;
+
+        // NOLINTBEGIN(*-reinterpret-cast)
+        static vector_type load(const double* ptr) noexcept { return _mm256_loadu_pd(ptr); }
+        static void store(double* ptr, vector_type v) noexcept { _mm256_storeu_pd(ptr, v); }
+        static vector_type set(double value) noexcept { return _mm256_set1_pd(value); }
+        static vector_type add(vector_type a, vector_type b) noexcept { return _mm256_add_pd(a, b); }
+        static vector_type sub(vector_type a, vector_type b) noexcept { return _mm256_sub_pd(a, b); }
+        static vector_type mul(vector_type a, vector_type b) noexcept { return _mm256_mul_pd(a, b); }
+        static vector_type max(vector_type a, vector_type b) noexcept { return _mm256_max_pd(a, b); }
+        static vector_type floor(vector_type v) noexcept { return _mm256_floor_pd(v); }
+        static vector_type greater_equal(vector_type a, vector_type b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GE_OQ); }
+        static vector_type select(vector_type mask, vector_type a, vector_type b) noexcept { return _mm256_blendv_pd(b, a, mask); }
+        static index_type to_index(vector_type v) noexcept { return _mm256_cvttpd_epi32(v); }
+        static index_type set_index(int value) noexcept { return _mm_set1_epi32(value); }
+        static index_type add(index_type a, index_type b) noexcept { return _mm_add_epi32(a, b); }
+        static index_type bit_and(index_type a, index_type b) noexcept { return _mm_and_si128(a, b); }
+        static index_type bit_xor(index_type a, index_type b) noexcept { return _mm_xor_si128(a, b); }
+        static index_type select(vector_type mask, index_type a, index_type b) noexcept
+        {
+            // the 64 bit lanes of the mask are all ones or all zeros, so their low halves are the 32 bit mask
+            const __m256i mask_bits = _mm256_castpd_si256(mask);
+            const __m128i mask32 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(_mm256_castsi256_si128(mask_bits)),
+                                                                   _mm_castsi128_ps(_mm256_extracti128_si256(mask_bits, 1)),
+                                                                   _MM_SHUFFLE(2, 0, 2, 0)));
+            return _mm_blendv_epi8(b, a, mask32);
+        }
+
+        static index_type gather(const std::int16_t* ptr, index_type indices) noexcept
+        {
+            const index_type values = _mm_i32gather_epi32(reinterpret_cast<const int*>(ptr), indices, 2);
+            return _mm_srai_epi32(_mm_slli_epi32(values, 16), 16);
+        }
+
+        static vector_type gather(const double* ptr, index_type indices) noexcept
+        {
+            return _mm256_i32gather_pd(ptr, _mm_slli_epi32(indices, 1), 8);
+        }
+        // NOLINTEND(*-reinterpret-cast)
+    };
+#endif
+
 } // namespace detail
 
 // open simplex noise implementation based on:
 // https://github.com/KdotJPG/OpenSimplex2
 
+// the 2d noise is the OpenSimplex2 (fast) lattice, the 3d and 4d noises follow OpenSimplex2's
+// rotated bcc and a4 lattices, with gradients picked through the permutation tables
 template<std::size_t N, typename T = double, std::size_t PermN = 2048>
-    requires(N >= 1 && N <= 3)
+    requires(N >= 1 && N <= 4)
 class open_simplex
 {
 private:
@@ -127,21 +391,29 @@ private:
     static constexpr glm::uint mask = static_cast<glm::uint>(PermN - 1);
 
 public:
+    using value_type = T;
     template<typename U>
     using point_type = glm::vec<N, U, glm::qualifier::packed_highp>;
+    using cell_type = glm::vec<N, int, glm::qualifier::packed_highp>;
+    using step_type = glm::vec<2, T, glm::qualifier::packed_highp>;
     using gradient_type = detail::gradient_type<N, T>;
     using permutation_type = std::int16_t;
 
+    static constexpr std::size_t permutation_count = PermN;
+
 public:
     constexpr open_simplex() noexcept = default;
 
     constexpr open_simplex(std::uint64_t seed)
     {
-        m_permutations.resize(PermN);
+        // one extra element, so that 32 bit gathers of the last permutation stay in bounds
+        m_permutations.resize(PermN + 1);
         m_gradient_permutations.resize(PermN);
 
-        std::iota(m_permutations.begin(), m_permutations.end(), 0);
-        std::shuffle(m_permutations.begin(), m_permutations.end(), random_generator(seed));
+        // random_generator::shuffle gives the same table with every standard library, switching
+        // to it from std::shuffle changed the noise of every seed, see CHANGELOG.md
+        std::iota(m_permutations.begin(), m_permutations.begin() + PermN, 0);
+        random_generator(seed).shuffle(std::span(m_permutations).first(PermN));
 
         for (std::size_t i = 0; i < m_gradient_permutations.size(); ++i)
         {
@@ -203,6 +475,548 @@ public:
         return value;
     }
 
+    // rotates the lattice so that xy slices look best, for 2d noise animated along z
+    template<typename U = T>
+    [[nodiscard]] constexpr U operator()(point_type<U> point) const noexcept
+        requires(N == 3)
+    {
+        const U xy = point.x + point.y;
+        const U s2 = xy * static_cast<U>(-0.211324865405187);
+        const U zz = point.z * static_cast<U>(0.577350269189626);
+
+        return base(point_type<U>{ point.x + s2 + zz, point.y + s2 + zz, xy * static_cast<U>(-0.577350269189626) + zz });
+    }
+
+    template<typename U = T>
+    [[nodiscard]] constexpr U operator()(U x, U y, U z) const noexcept
+        requires(N == 3)
+    {
+        return operator()({ x, y, z });
+    }
+
+    // two copies of the cubic lattice offset by half a cell (a bcc lattice),
+    // each contributes its closest point and the next closest one along an axis
+    template<typename U = T>
+    [[nodiscard]] constexpr U base(point_type<U> point) const noexcept
+        requires(N == 3)
+    {
+        constexpr U rsquared = static_cast<U>(0.6);
+
+        const point_type<U> point_base = glm::floor(point + static_cast<U>(0.5));
+        point_type<U> offset = point - point_base;
+        cell_type cell(point_base);
+
+        // -1 where the offset is positive, 1 where it's negative
+        cell_type sign{ offset.x >= 0 ? -1 : 1, offset.y >= 0 ? -1 : 1, offset.z >= 0 ? -1 : 1 };
+        point_type<U> distance = point_type<U>(sign) * -offset;
+
+        U value{};
+        U attenuation = (rsquared - offset.x * offset.x) - (offset.y * offset.y + offset.z * offset.z);
+
+        for (glm::uint copy = 0;; ++copy)
+        {
+            if (attenuation > 0)
+            {
+                value += (attenuation * attenuation) * (attenuation * attenuation) * extrapolate(cell, offset, copy);
+            }
+
+            glm::length_t axis = 2;
+
+            if (distance.x >= distance.y && distance.x >= distance.z)
+            {
+                axis = 0;
+            }
+            else if (distance.y > distance.x && distance.y >= distance.z)
+            {
+                axis = 1;
+            }
+
+            U second_attenuation = attenuation + distance[axis] + distance[axis];
+
+            if (second_attenuation > 1)
+            {
+                cell_type second_cell = cell;
+                point_type<U> second_offset = offset;
+
+                second_cell[axis] -= sign[axis];
+                second_offset[axis] += static_cast<U>(sign[axis]);
+                second_attenuation -= 1;
+
+                value += (second_attenuation * second_attenuation) * (second_attenuation * second_attenuation)
+                       * extrapolate(second_cell, second_offset, copy);
+            }
+
+            if (copy == 1)
+            {
+                break;
+            }
+
+            // move to the other lattice copy
+            distance = static_cast<U>(0.5) - distance;
+            offset = point_type<U>(sign) * distance;
+            attenuation += (static_cast<U>(0.75) - distance.x) - (distance.y + distance.z);
+
+            for (glm::length_t i = 0; i < 3; ++i)
+            {
+                cell[i] += sign[i] < 0 ? 1 : 0;
+            }
+
+            sign = -sign;
+        }
+
+        return value;
+    }
+
+    template<typename U = T>
+    [[nodiscard]] constexpr U operator()(point_type<U> point) const noexcept
+        requires(N == 4)
+    {
+        point += (point.x + point.y + point.z + point.w) * static_cast<U>(-0.138196601125011);
+
+        return base(point);
+    }
+
+    template<typename U = T>
+    [[nodiscard]] constexpr U operator()(U x, U y, U z, U w) const noexcept
+        requires(N == 4)
+    {
+        return operator()({ x, y, z, w });
+    }
+
+    // five copies of the a4 lattice, each shifted by a fifth of the main diagonal,
+    // each contributes the closest vertex of its simplex
+    template<typename U = T>
+    [[nodiscard]] constexpr U base(point_type<U> point) const noexcept
+        requires(N == 4)
+    {
+        constexpr U unskew = static_cast<U>(0.309016994374947);
+        constexpr U lattice_step = static_cast<U>(0.2);
+        constexpr U rsquared = static_cast<U>(0.6);
+
+        const point_type<U> point_base = glm::floor(point);
+        point_type<U> offset = point - point_base;
+        cell_type cell(point_base);
+
+        // start with the lattice copy that is sure to contribute
+        const U offset_sum = (offset.x + offset.y) + (offset.z + offset.w);
+        const int starting_copy = static_cast<int>(offset_sum * static_cast<U>(1.25));
+        const U starting_offset = static_cast<U>(starting_copy) * -lattice_step;
+
+        offset += starting_offset;
+
+        U unskewed_sum = (offset_sum + starting_offset * 4) * unskew;
+        int copy = starting_copy;
+
+        U value{};
+
+        for (int i = 0;; ++i)
+        {
+            const U score = static_cast<U>(1) + unskewed_sum * (static_cast<U>(-1) / unskew);
+
+            const auto step = [&](glm::length_t axis) {
+                cell[axis] += 1;
+                offset[axis] -= 1;
+                unskewed_sum -= unskew;
+            };
+
+            if (offset.x >= offset.y && offset.x >= offset.z && offset.x >= offset.w && offset.x >= score)
+            {
+                step(0);
+            }
+            else if (offset.y > offset.x && offset.y >= offset.z && offset.y >= offset.w && offset.y >= score)
+            {
+                step(1);
+            }
+            else if (offset.z > offset.x && offset.z > offset.y && offset.z >= offset.w && offset.z >= score)
+            {
+                step(2);
+            }
+            else if (offset.w > offset.x && offset.w > offset.y && offset.w > offset.z && offset.w >= score)
+            {
+                step(3);
+            }
+
+            const point_type<U> d = offset + unskewed_sum;
+            U attenuation = (d.x * d.x + d.y * d.y) + (d.z * d.z + d.w * d.w);
+
+            if (attenuation < rsquared)
+            {
+                attenuation -= rsquared;
+                attenuation *= attenuation;
+                value += attenuation * attenuation * extrapolate(cell, d, static_cast<glm::uint>(copy));
+            }
+
+            if (i == 4)
+            {
+                break;
+            }
+
+            // move to the next lattice copy
+            offset += lattice_step;
+            unskewed_sum += lattice_step * 4 * unskew;
+            --copy;
+
+            if (i == starting_copy)
+            {
+                cell -= cell_type(1);
+                copy += 5;
+            }
+        }
+
+        return value;
+    }
+
+    // evaluates the noise at the points (xs[i], ys[i]), several points at a time when possible,
+    // the values are equal to the ones of operator() up to rounding, the compiler may contract
+    // either of them into fused multiply adds, and points on the diagonal of a cell may pick the
+    // other triangle
+    void evaluate(std::span<const T> xs, std::span<const T> ys, std::span<T> values) const noexcept
+        requires(N == 2)
+    {
+        FLOW_ASSERT(xs.size() == values.size() && ys.size() == values.size(), "span sizes don't match");
+
+        std::size_t i = 0;
+
+#if defined(__AVX2__)
+        if constexpr (std::same_as<T, float> || std::same_as<T, double>)
+        {
+            i = evaluate_simd(xs.data(), ys.data(), values.data(), values.size());
+        }
+#endif
+
+        for (; i < values.size(); ++i)
+        {
+            values[i] = operator()(xs[i], ys[i]);
+        }
+    }
+
+    void evaluate(std::span<const T> xs, std::span<const T> ys, std::span<const T> zs, std::span<T> values) const noexcept
+        requires(N == 3)
+    {
+        FLOW_ASSERT(xs.size() == values.size() && ys.size() == values.size() && zs.size() == values.size(),
+                    "span sizes don't match");
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = operator()(xs[i], ys[i], zs[i]);
+        }
+    }
+
+    void evaluate(std::span<const T> xs,
+                  std::span<const T> ys,
+                  std::span<const T> zs,
+                  std::span<const T> ws,
+                  std::span<T> values) const noexcept
+        requires(N == 4)
+    {
+        FLOW_ASSERT(xs.size() == values.size() && ys.size() == values.size() && zs.size() == values.size()
+                        && ws.size() == values.size(),
+                    "span sizes don't match");
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = operator()(xs[i], ys[i], zs[i], ws[i]);
+        }
+    }
+
+    // evaluates the noise on a width * height grid of points in the xy plane through origin, row by row:
+    // values[y * width + x] = noise(origin.x + x * step.x, origin.y + y * step.y, origin.z, origin.w)
+    void fill(std::span<T> values, point_type<T> origin, step_type step, std::size_t width, std::size_t height) const
+        requires(N >= 2)
+    {
+        FLOW_ASSERT(values.size() >= width * height, "values span is too small");
+
+        std::vector<T> xs(width);
+        std::vector<T> ys(width);
+
+        // every row has the same x coordinates
+        for (std::size_t x = 0; x < width; ++x)
+        {
+            xs[x] = origin.x + static_cast<T>(x) * step.x;
+        }
+
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            const std::span<T> row = values.subspan(y * width, width);
+
+            if constexpr (N == 2)
+            {
+                std::fill(ys.begin(), ys.end(), origin.y + static_cast<T>(y) * step.y);
+                evaluate(xs, ys, row);
+            }
+            else
+            {
+                point_type<T> point = origin;
+                point.y = origin.y + static_cast<T>(y) * step.y;
+
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    point.x = xs[x];
+                    row[x] = operator()(point);
+                }
+            }
+        }
+    }
+
+    // the tables the noise is computed from, for evaluating it elsewhere, e.g. on the gpu:
+    // the gradient of the 2d lattice point (x, y) is gradient_permutations()[permutations()[x & mask] ^ (y & mask)]
+    [[nodiscard]] constexpr std::span<const permutation_type> permutations() const noexcept
+    {
+        return std::span(m_permutations).first(std::min(m_permutations.size(), PermN));
+    }
+
+    [[nodiscard]] constexpr std::span<const gradient_type> gradient_permutations() const noexcept
+    {
+        return m_gradient_permutations;
+    }
+
+private:
+    // the gradient of a lattice point, hashed through one permutation per axis,
+    // copy tells apart the lattice copies whose points share integer coordinates
+    [[nodiscard]] constexpr const gradient_type& lattice_gradient(cell_type cell, glm::uint copy) const noexcept
+    {
+        glm::uint hash = static_cast<glm::uint>(cell[0]) & mask;
+
+        for (glm::length_t i = 1; i < static_cast<glm::length_t>(N); ++i)
+        {
+            hash = static_cast<glm::uint>(m_permutations[hash]) ^ (static_cast<glm::uint>(cell[i]) & mask);
+        }
+
+        return m_gradient_permutations[static_cast<std::size_t>(m_permutations[(hash + copy) & mask])];
+    }
+
+    template<typename U>
+    [[nodiscard]] constexpr U extrapolate(cell_type cell, point_type<U> d, glm::uint copy) const noexcept
+    {
+        return glm::dot(point_type<U>(lattice_gradient(cell, copy)), d);
+    }
+
+#if defined(__AVX2__)
+    // evaluates the points in groups of the simd width, with the operations of operator(),
+    // returns the number of points evaluated
+    std::size_t evaluate_simd(const T* xs, const T* ys, T* values, std::size_t count) const noexcept
+        requires(N == 2)
+    {
+        using simd = detail::open_simplex_simd<T>;
+        using vector_type = typename simd::vector_type;
+        using index_type = typename simd::index_type;
+
+        static_assert(sizeof(gradient_type) == 2 * sizeof(T), "gradients must be packed");
+
+        constexpr auto& lattice = detail::lattice_points<N, T>;
+
+        const vector_type skew = simd::set(static_cast<T>(0.366025403784439));
+        const vector_type unskew = simd::set(static_cast<T>(-0.211324865405187));
+        const vector_type half = simd::set(static_cast<T>(0.5));
+        const vector_type one = simd::set(static_cast<T>(1));
+        const vector_type zero = simd::set(static_cast<T>(0));
+        const index_type index_mask = simd::set_index(static_cast<int>(mask));
+
+        // NOLINTNEXTLINE(*-reinterpret-cast)
+        const T* gradients_ptr = reinterpret_cast<const T*>(m_gradient_permutations.data());
+
+        std::size_t i = 0;
+
+        for (; i + simd::width <= count; i += simd::width)
+        {
+            vector_type x = simd::load(xs + i);
+            vector_type y = simd::load(ys + i);
+
+            const vector_type s = simd::mul(simd::add(x, y), skew);
+            x = simd::add(x, s);
+            y = simd::add(y, s);
+
+            const vector_type base_x = simd::floor(x);
+            const vector_type base_y = simd::floor(y);
+            vector_type offset_x = simd::sub(x, base_x);
+            vector_type offset_y = simd::sub(y, base_y);
+
+            // operator() starts from lattice point 1 instead of 0 where this is set
+            const vector_type upper = simd::greater_equal(simd::add(simd::mul(simd::sub(offset_y, offset_x), half), one), one);
+
+            const vector_type t = simd::mul(simd::add(offset_x, offset_y), unskew);
+            offset_x = simd::add(offset_x, t);
+            offset_y = simd::add(offset_y, t);
+
+            const index_type cell_x = simd::to_index(base_x);
+            const index_type cell_y = simd::to_index(base_y);
+
+            vector_type value = zero;
+
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                const auto& a = lattice[k];
+                const auto& b = lattice[k + 1];
+
+                const vector_type d_x = simd::add(offset_x, simd::select(upper, simd::set(b.d.x), simd::set(a.d.x)));
+                const vector_type d_y = simd::add(offset_y, simd::select(upper, simd::set(b.d.y), simd::set(a.d.y)));
+
+                vector_type attenuation = simd::sub(half, simd::add(simd::mul(d_x, d_x), simd::mul(d_y, d_y)));
+                attenuation = simd::max(attenuation, zero);
+
+                const index_type point_x = simd::bit_and(
+                    simd::add(cell_x, simd::select(upper, simd::set_index(b.sv.x), simd::set_index(a.sv.x))), index_mask);
+                const index_type point_y = simd::bit_and(
+                    simd::add(cell_y, simd::select(upper, simd::set_index(b.sv.y), simd::set_index(a.sv.y))), index_mask);
+
+                const index_type gradient_index = simd::bit_xor(simd::gather(m_permutations.data(), point_x), point_y);
+
+                const vector_type gradient_x = simd::gather(gradients_ptr, gradient_index);
+                const vector_type gradient_y = simd::gather(gradients_ptr + 1, gradient_index);
+
+                const vector_type extrapolation = simd::add(simd::mul(gradient_x, d_x), simd::mul(gradient_y, d_y));
+
+                attenuation = simd::mul(attenuation, attenuation);
+                value = simd::add(value, simd::mul(simd::mul(attenuation, attenuation), extrapolation));
+            }
+
+            simd::store(values + i, value);
+        }
+
+        return i;
+    }
+#endif
+
+private:
+    std::vector<permutation_type> m_permutations;
+    std::vector<gradient_type> m_gradient_permutations;
+};
+
+// 2d noise in 16.16 fixed point, computed with integer operations only and with a permutation table
+// shuffled by random_generator::shuffle, so it gives bit identical results on every platform,
+// compiler and standard library, for simulations that run in lockstep
+// it stays within 5e-4 of the double noise over the whole 16.16 range, the gradients are stored
+// as 16 bit integers
+template<std::size_t PermN>
+class open_simplex<2, fixed16_16_t, PermN>
+{
+private:
+    using raw_type = std::int64_t;
+    using gradient_type = detail::fixed_gradient_type<2>;
+
+    static constexpr std::size_t fraction_bit_count = fixed16_16_t::fraction_bit_count;
+    static constexpr std::size_t constant_fraction_bit_count = detail::fixed_constant_fraction_bit_count;
+    static constexpr std::size_t gradient_fraction_bit_count = detail::fixed_gradient_fraction_bit_count;
+    static constexpr raw_type one = raw_type{ 1 } << fraction_bit_count;
+    static constexpr raw_type half = one / 2;
+
+    // the skew factors have 30 fraction bits, so up to x + y = 2^16 the skew is off by at most
+    // two units of the last place of the points
+    static constexpr raw_type skew = detail::to_fixed_constant(0.366025403784439);
+    static constexpr raw_type unskew = detail::to_fixed_constant(-0.211324865405187);
+
+    static constexpr auto& lattice_points = detail::fixed_lattice_points<fraction_bit_count>;
+    static constexpr std::array gradients = detail::generate_fixed_gradients<2, PermN>();
+    static constexpr glm::uint mask = static_cast<glm::uint>(PermN - 1);
+
+public:
+    using value_type = fixed16_16_t;
+    using point_type = glm::vec<2, value_type, glm::qualifier::packed_highp>;
+    using permutation_type = std::int16_t;
+
+public:
+    constexpr open_simplex() noexcept = default;
+
+    constexpr open_simplex(std::uint64_t seed)
+    {
+        m_permutations.resize(PermN);
+        m_gradient_permutations.resize(PermN);
+
+        std::iota(m_permutations.begin(), m_permutations.end(), 0);
+        random_generator(seed).shuffle(std::span(m_permutations));
+
+        for (std::size_t i = 0; i < m_gradient_permutations.size(); ++i)
+        {
+            m_gradient_permutations[i] = gradients[m_permutations[i]];
+        }
+    }
+
+    [[nodiscard]] constexpr value_type operator()(point_type point) const noexcept
+    {
+        return operator()(point.x, point.y);
+    }
+
+    [[nodiscard]] constexpr value_type operator()(value_type x, value_type y) const noexcept
+    {
+        raw_type point_x = x.raw();
+        raw_type point_y = y.raw();
+
+        // right shifts of negative values round down, like the floor of the floating point noise
+        const raw_type s = ((point_x + point_y) * skew) >> constant_fraction_bit_count;
+        point_x += s;
+        point_y += s;
+
+        const raw_type base_x = point_x >> fraction_bit_count;
+        const raw_type base_y = point_y >> fraction_bit_count;
+        raw_type offset_x = point_x & (one - 1);
+        raw_type offset_y = point_y & (one - 1);
+
+        const std::size_t index = offset_y >= offset_x ? 1 : 0;
+
+        const raw_type t = ((offset_x + offset_y) * unskew) >> constant_fraction_bit_count;
+        offset_x += t;
+        offset_y += t;
+
+        raw_type value{};
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            const auto& lattice_point = lattice_points[index + i];
+
+            const raw_type d_x = offset_x + lattice_point.d_x;
+            const raw_type d_y = offset_y + lattice_point.d_y;
+
+            raw_type attenuation = half - ((d_x * d_x + d_y * d_y) >> fraction_bit_count);
+
+            if (attenuation <= 0)
+            {
+                continue;
+            }
+
+            const glm::uint point_mask_x = static_cast<glm::uint>(base_x + lattice_point.x) & mask;
+            const glm::uint point_mask_y = static_cast<glm::uint>(base_y + lattice_point.y) & mask;
+            const gradient_type& gradient = m_gradient_permutations[static_cast<glm::uint>(m_permutations[point_mask_x]) ^ point_mask_y];
+
+            const raw_type extrapolation = gradient.x * d_x + gradient.y * d_y;
+
+            // attenuation^4 keeps 32 fraction bits, 2 * 16 + 8 are dropped on the way
+            attenuation = (attenuation * attenuation) >> (fraction_bit_count / 2);
+            attenuation = (attenuation * attenuation) >> fraction_bit_count;
+            value += attenuation * extrapolation;
+        }
+
+        // the sum has 32 fraction bits from the attenuation and 16 + 8 from the extrapolation
+        return value_type::from_raw(static_cast<std::int32_t>(value >> (2 * fraction_bit_count + gradient_fraction_bit_count)));
+    }
+
+    void evaluate(std::span<const value_type> xs, std::span<const value_type> ys, std::span<value_type> values) const noexcept
+    {
+        FLOW_ASSERT(xs.size() == values.size() && ys.size() == values.size(), "span sizes don't match");
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = operator()(xs[i], ys[i]);
+        }
+    }
+
+    // values[y * width + x] = noise(origin.x + x * step.x, origin.y + y * step.y)
+    void fill(std::span<value_type> values, point_type origin, point_type step, std::size_t width, std::size_t height) const
+    {
+        FLOW_ASSERT(values.size() >= width * height, "values span is too small");
+
+        value_type y = origin.y;
+
+        for (std::size_t row = 0; row < height; ++row, y += step.y)
+        {
+            value_type x = origin.x;
+
+            for (std::size_t column = 0; column < width; ++column, x += step.x)
+            {
+                values[row * width + column] = operator()(x, y);
+            }
+        }
+    }
+
 private:
     std::vector<permutation_type> m_permutations;
     std::vector<gradient_type> m_gradient_permutations;
@@ -213,6 +1027,7 @@ class basic_noise_generator
 {
 public:
     using generator_type = GeneratorT;
+    using value_type = typename generator_type::value_type;
 
 public:
     constexpr basic_noise_generator(std::uint64_t seed)
@@ -225,6 +1040,23 @@ public:
         return m_generator(std::forward<ArgsT>(args)...);
     }
 
+    template<typename... ArgsT>
+    void evaluate(ArgsT&&... args) const
+    {
+        m_generator.evaluate(std::forward<ArgsT>(args)...);
+    }
+
+    template<typename... ArgsT>
+    void fill(ArgsT&&... args) const
+    {
+        m_generator.fill(std::forward<ArgsT>(args)...);
+    }
+
+    [[nodiscard]] constexpr const generator_type& generator() const noexcept
+    {
+        return m_generator;
+    }
+
 private:
     generator_type m_generator;
 };
@@ -232,4 +1064,11 @@ private:
 template<std::size_t N>
 using noise_generator = basic_noise_generator<open_simplex<N, double, 2048>>;
 
+// half the table size of noise_generator, so the 2d tables fit in the l1 cache,
+// and twice as many points per simd batch
+template<std::size_t N>
+using float_noise_generator = basic_noise_generator<open_simplex<N, float, 2048>>;
+
+using fixed_noise_generator = basic_noise_generator<open_simplex<2, fixed16_16_t, 2048>>;
+
 } // namespace flow
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include "../core/assertion.hpp"
+#include "helpers.hpp"
+#include "noise.hpp"
+
+namespace flow {
+
+using noise_tile_coordinates = glm::vec<2, std::int32_t, glm::packed_highp>;
+
+struct noise_tile_hash
+{
+    [[nodiscard]] std::size_t operator()(noise_tile_coordinates tile) const noexcept
+    {
+        return hash_combine(std::hash<std::int32_t>{}(tile.x), tile.y);
+    }
+};
+
+// samples a 2d noise field through a cache of square tiles of noise values
+// tile (x, y) holds tile_size + 1 samples per side, spaced sample_spacing apart, starting at
+// (x, y) * tile_size * sample_spacing, so every point is interpolated from the samples of one tile
+// the least recently used tiles are dropped once more than capacity tiles are cached, and the
+// oldest requests once more than capacity tiles are queued, so finished tiles that are never
+// collected don't pile up
+// missing tiles are generated by worker threads, sample waits for at most one tile: it generates
+// the tile itself unless a worker has already started it, try_sample never waits
+// the cache must be used by a single thread, the generator must be safe to call from several
+template<typename GeneratorT>
+class basic_noise_field_cache
+{
+public:
+    using generator_type = GeneratorT;
+    using value_type = typename generator_type::value_type;
+    using point_type = glm::vec<2, value_type, glm::packed_highp>;
+    using tile_type = std::vector<value_type>;
+
+public:
+    // worker_count 0 uses one worker per core, except the calling one
+    basic_noise_field_cache(generator_type generator,
+                            std::size_t tile_size,
+                            value_type sample_spacing,
+                            std::size_t capacity,
+                            std::size_t worker_count = 0)
+        : m_generator(std::move(generator))
+        , m_tile_size(tile_size)
+        , m_sample_spacing(sample_spacing)
+        , m_capacity(capacity)
+    {
+        FLOW_ASSERT(tile_size > 0, "tile size must be positive");
+        FLOW_ASSERT(sample_spacing > value_type{ 0 }, "sample spacing must be positive");
+        FLOW_ASSERT(capacity > 0, "capacity must be positive");
+
+        if (worker_count == 0)
+        {
+            worker_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+        }
+
+        m_workers.reserve(worker_count);
+
+        for (std::size_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back([this](std::stop_token stop_token) { run(stop_token); });
+        }
+    }
+
+    basic_noise_field_cache(const basic_noise_field_cache& other) = delete;
+    basic_noise_field_cache& operator=(const basic_noise_field_cache& other) = delete;
+
+    ~basic_noise_field_cache()
+    {
+        for (auto& worker : m_workers)
+        {
+            worker.request_stop();
+        }
+
+        m_condition.notify_all();
+    }
+
+    // the bilinearly interpolated noise at point, waits for at most one tile when it is missing
+    [[nodiscard]] value_type sample(point_type point)
+    {
+        const auto [tile, local] = locate(point);
+
+        return interpolate(acquire(tile), local);
+    }
+
+    [[nodiscard]] value_type sample(value_type x, value_type y)
+    {
+        return sample(point_type{ x, y });
+    }
+
+    // the interpolated noise at point if its tile is cached, otherwise queues the tile and returns nothing
+    [[nodiscard]] std::optional<value_type> try_sample(point_type point)
+    {
+        const auto [tile, local] = locate(point);
+
+        const tile_type* values = find(tile);
+
+        if (values == nullptr)
+        {
+            values = collect(tile);
+        }
+
+        if (values == nullptr)
+        {
+            request(tile);
+            return std::nullopt;
+        }
+
+        return interpolate(*values, local);
+    }
+
+    // values[y * width + x] = sample(origin.x + x * step.x, origin.y + y * step.y)
+    // every missing tile under the rectangle is queued before the first one is waited for
+    void sample_rect(std::span<value_type> values, point_type origin, point_type step, std::size_t width, std::size_t height)
+    {
+        FLOW_ASSERT(values.size() >= width * height, "values span is too small");
+
+        if (width == 0 || height == 0)
+        {
+            return;
+        }
+
+        prefetch(origin, origin + step * point_type(static_cast<value_type>(width - 1), static_cast<value_type>(height - 1)));
+
+        // neighbouring points are mostly in the same tile
+        noise_tile_coordinates current_tile{};
+        const tile_type* current_values = nullptr;
+
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            for (std::size_t x = 0; x < width; ++x)
+            {
+                const auto [tile, local] = locate(origin + step * point_type(static_cast<value_type>(x), static_cast<value_type>(y)));
+
+                if (current_values == nullptr || tile != current_tile)
+                {
+                    current_tile = tile;
+                    current_values = &acquire(tile);
+                }
+
+                values[y * width + x] = interpolate(*current_values, local);
+            }
+        }
+    }
+
+    // queues every missing tile that overlaps the rectangle between the corners
+    void prefetch(point_type first, point_type last)
+    {
+        const noise_tile_coordinates first_tile = locate(glm::min(first, last)).tile;
+        const noise_tile_coordinates last_tile = locate(glm::max(first, last)).tile;
+
+        for (std::int32_t y = first_tile.y; y <= last_tile.y; ++y)
+        {
+            for (std::int32_t x = first_tile.x; x <= last_tile.x; ++x)
+            {
+                request({ x, y });
+            }
+        }
+    }
+
+    // moves the tiles finished by the workers into the cache, without waiting for the others
+    void update()
+    {
+        for (auto it = m_pending.begin(); it != m_pending.end();)
+        {
+            if (it->second.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                const noise_tile_coordinates tile = it->first;
+                pending_tile pending = take_pending(it++);
+                insert(tile, pending.result.get());
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // drops the cached tiles, the queued ones are still generated
+    void clear() noexcept
+    {
+        m_tiles.clear();
+        m_tile_lookup.clear();
+    }
+
+    [[nodiscard]] bool contains(noise_tile_coordinates tile) const
+    {
+        return m_tile_lookup.contains(tile);
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+        return m_tiles.size();
+    }
+
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    // at most capacity
+    [[nodiscard]] constexpr std::size_t pending_count() const noexcept
+    {
+        return m_pending.size();
+    }
+
+    [[nodiscard]] constexpr std::size_t tile_size() const noexcept
+    {
+        return m_tile_size;
+    }
+
+    [[nodiscard]] constexpr value_type sample_spacing() const noexcept
+    {
+        return m_sample_spacing;
+    }
+
+    [[nodiscard]] constexpr const generator_type& generator() const noexcept
+    {
+        return m_generator;
+    }
+
+private:
+    struct location
+    {
+        noise_tile_coordinates tile;
+        point_type local; // in samples from the first sample of the tile
+    };
+
+    struct tile_job
+    {
+        noise_tile_coordinates tile;
+        std::atomic<bool> claimed{ false }; // set by whoever generates the tile
+        std::promise<tile_type> promise{};
+    };
+
+    using request_list = std::list<noise_tile_coordinates>;
+
+    struct pending_tile
+    {
+        std::shared_ptr<tile_job> job;
+        std::future<tile_type> result;
+        typename request_list::iterator request;
+    };
+
+    using pending_map = std::unordered_map<noise_tile_coordinates, pending_tile, noise_tile_hash>;
+
+    struct cached_tile
+    {
+        noise_tile_coordinates tile;
+        tile_type values;
+    };
+
+    using tile_list = std::list<cached_tile>;
+
+    [[nodiscard]] location locate(point_type point) const noexcept
+    {
+        const point_type samples = point / m_sample_spacing;
+        const point_type tile_samples = point_type(static_cast<value_type>(m_tile_size));
+        const point_type tile = glm::floor(samples / tile_samples);
+
+        return { noise_tile_coordinates(tile), samples - tile * tile_samples };
+    }
+
+    [[nodiscard]] value_type interpolate(const tile_type& values, point_type local) const noexcept
+    {
+        const std::size_t stride = m_tile_size + 1;
+
+        // the local coordinates can round to tile_size, whose samples are still in the tile
+        const point_type base = glm::clamp(glm::floor(local), point_type(0), point_type(static_cast<value_type>(m_tile_size - 1)));
+        const point_type t = local - base;
+
+        const auto x = static_cast<std::size_t>(base.x);
+        const auto y = static_cast<std::size_t>(base.y);
+
+        const value_type* row0 = values.data() + y * stride + x;
+        const value_type* row1 = row0 + stride;
+
+        return glm::mix(glm::mix(row0[0], row0[1], t.x), glm::mix(row1[0], row1[1], t.x), t.y);
+    }
+
+    [[nodiscard]] tile_type generate(noise_tile_coordinates tile) const
+    {
+        const std::size_t stride = m_tile_size + 1;
+        const point_type origin = point_type(tile) * (static_cast<value_type>(m_tile_size) * m_sample_spacing);
+
+        tile_type values(stride * stride);
+        m_generator.fill(std::span(values), origin, point_type(m_sample_spacing), stride, stride);
+
+        return values;
+    }
+
+    // marks the tile as most recently used
+    [[nodiscard]] const tile_type* find(noise_tile_coordinates tile)
+    {
+        auto it = m_tile_lookup.find(tile);
+
+        if (it == m_tile_lookup.end())
+        {
+            return nullptr;
+        }
+
+        m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+
+        return &it->second->values;
+    }
+
+    const tile_type& insert(noise_tile_coordinates tile, tile_type values)
+    {
+        if (auto it = m_tile_lookup.find(tile); it != m_tile_lookup.end())
+        {
+            m_tiles.splice(m_tiles.begin(), m_tiles, it->second);
+            return it->second->values;
+        }
+
+        if (m_tiles.size() >= m_capacity)
+        {
+            m_tile_lookup.erase(m_tiles.back().tile);
+            m_tiles.pop_back();
+        }
+
+        m_tiles.push_front({ tile, std::move(values) });
+        m_tile_lookup.emplace(tile, m_tiles.begin());
+
+        return m_tiles.front().values;
+    }
+
+    // moves the tile into the cache if a worker has finished it
+    [[nodiscard]] const tile_type* collect(noise_tile_coordinates tile)
+    {
+        auto it = m_pending.find(tile);
+
+        if (it == m_pending.end() || it->second.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return nullptr;
+        }
+
+        pending_tile pending = take_pending(it);
+
+        return &insert(tile, pending.result.get());
+    }
+
+    const tile_type& acquire(noise_tile_coordinates tile)
+    {
+        if (const tile_type* values = find(tile))
+        {
+            return *values;
+        }
+
+        auto it = m_pending.find(tile);
+
+        if (it == m_pending.end())
+        {
+            return insert(tile, generate(tile));
+        }
+
+        pending_tile pending = take_pending(it);
+
+        // a worker skips the job once it's claimed, otherwise it's already generating the tile
+        if (!pending.job->claimed.exchange(true))
+        {
+            return insert(tile, generate(tile));
+        }
+
+        return insert(tile, pending.result.get());
+    }
+
+    void request(noise_tile_coordinates tile)
+    {
+        if (m_tile_lookup.contains(tile) || m_pending.contains(tile))
+        {
+            return;
+        }
+
+        if (m_workers.empty())
+        {
+            insert(tile, generate(tile));
+            return;
+        }
+
+        // the oldest request is the likeliest to be stale, e.g. behind a camera that moved on,
+        // a worker skips it if it hasn't started it, otherwise its tile is thrown away
+        if (m_pending.size() >= m_capacity)
+        {
+            take_pending(m_pending.find(m_requests.front())).job->claimed.store(true);
+        }
+
+        auto next = std::make_shared<tile_job>();
+        next->tile = tile;
+
+        m_requests.push_back(tile);
+        m_pending.emplace(tile, pending_tile{ next, next->promise.get_future(), std::prev(m_requests.end()) });
+
+        {
+            std::lock_guard lock{ m_mutex };
+            m_jobs.push_back(std::move(next));
+        }
+
+        m_condition.notify_one();
+    }
+
+    pending_tile take_pending(typename pending_map::iterator it)
+    {
+        pending_tile pending = std::move(it->second);
+        m_requests.erase(pending.request);
+        m_pending.erase(it);
+
+        return pending;
+    }
+
+    void run(std::stop_token stop_token)
+    {
+        while (true)
+        {
+            std::shared_ptr<tile_job> next{};
+
+            {
+                std::unique_lock lock{ m_mutex };
+
+                if (!m_condition.wait(lock, stop_token, [this] { return !m_jobs.empty(); }))
+                {
+                    return;
+                }
+
+                next = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            if (next->claimed.exchange(true))
+            {
+                continue;
+            }
+
+            try
+            {
+                next->promise.set_value(generate(next->tile));
+            }
+            catch (...)
+            {
+                next->promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+private:
+    generator_type m_generator;
+    std::size_t m_tile_size;
+    value_type m_sample_spacing;
+    std::size_t m_capacity;
+
+    tile_list m_tiles{}; // most recently used first
+    std::unordered_map<noise_tile_coordinates, typename tile_list::iterator, noise_tile_hash> m_tile_lookup{};
+    pending_map m_pending{};
+    request_list m_requests{}; // the pending tiles, oldest first
+
+    std::mutex m_mutex{};
+    std::condition_variable_any m_condition{};
+    std::deque<std::shared_ptr<tile_job>> m_jobs{};
+
+    // last, so the workers stop before the rest is destroyed
+    std::vector<std::jthread> m_workers{};
+};
+
+using noise_field_cache = basic_noise_field_cache<noise_generator<2>>;
+
+} // namespace flow
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <functional>
 #include <ostream>
 #include <span>
 
+#include "byteswap.hpp"
 #include "concepts.hpp"
 #include "serialization.hpp"
+#include "stream_backend.hpp"
 
 namespace flow {
 
@@ -37,37 +43,63 @@ public:
         : ostream_view(&out)
     {}
 
+    constexpr ostream_view(ostream_backend* out) noexcept
+        : m_backend{ out }
+    {}
+
+    constexpr ostream_view(ostream_backend& out) noexcept
+        : ostream_view(&out)
+    {}
+
+    // with a foreign byte order, values that are not byte_order_convertible set the failbit
     template<concepts::trivially_copyable T>
     ostream_view& write(const T& data)
     {
-        if (m_out)
+        if constexpr (sizeof(T) > 1)
         {
-            // NOLINTNEXTLINE(*-reinterpret-cast)
-            m_out->write(reinterpret_cast<const char*>(&data), sizeof(data));
+            if (m_byte_order != std::endian::native)
+            {
+                if constexpr (concepts::byte_order_convertible<T>)
+                {
+                    return write_swapped(std::span<const T>(&data, 1));
+                }
+                else
+                {
+                    setstate(failbit);
+                    return *this;
+                }
+            }
         }
-        return *this;
+
+        return write_bytes(std::as_bytes(std::span(&data, 1)));
     }
 
     template<concepts::trivially_copyable T>
     ostream_view& write(std::span<T> span)
     {
-        if (m_out)
-        {
-            // NOLINTNEXTLINE(*-reinterpret-cast)
-            m_out->write(reinterpret_cast<const char*>(span.data()), span.size_bytes());
-        }
-        return *this;
+        return write(std::span<const T>(span));
     }
 
     template<concepts::trivially_copyable T>
     ostream_view& write(std::span<const T> span)
     {
-        if (m_out)
+        if constexpr (sizeof(T) > 1)
         {
-            // NOLINTNEXTLINE(*-reinterpret-cast)
-            m_out->write(reinterpret_cast<const char*>(span.data()), span.size_bytes());
+            if (m_byte_order != std::endian::native)
+            {
+                if constexpr (concepts::byte_order_convertible<T>)
+                {
+                    return write_swapped(span);
+                }
+                else
+                {
+                    setstate(failbit);
+                    return *this;
+                }
+            }
         }
-        return *this;
+
+        return write_bytes(std::as_bytes(span));
     }
 
     template<typename T, concepts::serializer<T> SerializerT>
@@ -115,6 +147,10 @@ public:
         {
             m_out->seekp(position);
         }
+        else if (m_backend)
+        {
+            m_backend->seek(position);
+        }
         return *this;
     }
 
@@ -124,32 +160,72 @@ public:
         {
             m_out->seekp(offset, direction);
         }
+        else if (m_backend)
+        {
+            m_backend->seek(offset, direction);
+        }
         return *this;
     }
 
     [[nodiscard]] pos_type tell()
     {
-        return m_out ? m_out->tellp() : pos_type{ -1 };
+        if (m_out)
+        {
+            return m_out->tellp();
+        }
+        return m_backend ? m_backend->tell() : pos_type{ -1 };
+    }
+
+    ostream_view& flush()
+    {
+        if (m_out)
+        {
+            m_out->flush();
+        }
+        else if (m_backend)
+        {
+            m_backend->flush();
+        }
+        return *this;
+    }
+
+    // the byte order that arithmetic and enum values are written in, also inside arrays and
+    // aggregates (see byteswap_members), other types of more than one byte can only be
+    // written in the native order, which is the default and writes every value with a single write
+    constexpr ostream_view& set_byte_order(std::endian order) noexcept
+    {
+        m_byte_order = order;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr std::endian byte_order() const noexcept
+    {
+        return m_byte_order;
+    }
+
+    [[nodiscard]] constexpr bool is_native_byte_order() const noexcept
+    {
+        return m_byte_order == std::endian::native;
     }
 
     [[nodiscard]] bool good() const
     {
-        return m_out && m_out->good();
+        return m_out ? m_out->good() : (m_backend && m_backend->good());
     }
 
     [[nodiscard]] bool eof() const
     {
-        return !m_out || m_out->eof();
+        return m_out ? m_out->eof() : (!m_backend || m_backend->eof());
     }
 
     [[nodiscard]] bool fail() const
     {
-        return !m_out || m_out->fail();
+        return m_out ? m_out->fail() : (!m_backend || m_backend->fail());
     }
 
     [[nodiscard]] bool bad() const
     {
-        return !m_out || m_out->bad();
+        return m_out ? m_out->bad() : (!m_backend || m_backend->bad());
     }
 
     [[nodiscard]] bool operator!() const
@@ -168,10 +244,72 @@ public:
         {
             m_out->clear(state);
         }
+        else if (m_backend)
+        {
+            m_backend->clear(state);
+        }
+    }
+
+    void setstate(iostate state)
+    {
+        if (m_out)
+        {
+            m_out->setstate(state);
+        }
+        else if (m_backend)
+        {
+            m_backend->setstate(state);
+        }
+    }
+
+private:
+    ostream_view& write_bytes(std::span<const std::byte> bytes)
+    {
+        if (m_out)
+        {
+            // NOLINTNEXTLINE(*-reinterpret-cast)
+            m_out->write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        }
+        else if (m_backend)
+        {
+            m_backend->write(bytes);
+        }
+        return *this;
+    }
+
+    // swaps the bytes of the values through a small buffer, one chunk at a time
+    template<concepts::byte_order_convertible T>
+    ostream_view& write_swapped(std::span<const T> span)
+    {
+        std::array<T, std::max<std::size_t>(1, swap_buffer_size / sizeof(T))> buffer; // NOLINT(*-member-init)
+
+        while (!span.empty())
+        {
+            const std::size_t count = std::min(span.size(), buffer.size());
+
+            if constexpr (concepts::byte_swappable<T>)
+            {
+                byteswap(span.first(count), std::span<T>(buffer));
+            }
+            else
+            {
+                std::memcpy(buffer.data(), span.data(), count * sizeof(T));
+                std::for_each_n(buffer.begin(), count, [](T& value) { byteswap_members(value); });
+            }
+
+            write_bytes(std::as_bytes(std::span(buffer).first(count)));
+
+            span = span.subspan(count);
+        }
+        return *this;
     }
 
 private:
+    static constexpr std::size_t swap_buffer_size = 4096;
+
     std::ostream* m_out{ nullptr };
+    ostream_backend* m_backend{ nullptr };
+    std::endian m_byte_order{ std::endian::native };
 };
 
 template<concepts::trivially_copyable T>
@@ -188,7 +326,7 @@ struct serializer<std::span<T>>
 {
     void operator()(ostream_view out, std::span<T> span) const
     {
-        if (concepts::trivially_copyable<T>)
+        if constexpr (concepts::trivially_copyable<T>)
         {
             out.write(span);
         }
@@ -207,7 +345,7 @@ struct serializer<std::span<const T>>
 {
     void operator()(ostream_view out, std::span<const T> span) const
     {
-        if (concepts::trivially_copyable<T>)
+        if constexpr (concepts::trivially_copyable<T>)
         {
             out.write(span);
         }
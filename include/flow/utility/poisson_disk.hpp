@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include "../core/assertion.hpp"
+#include "../math/vec2.hpp"
+#include "../math/vec2_math.hpp"
+#include "noise.hpp"
+#include "random.hpp"
+
+namespace flow {
+
+// blue noise points in [0, size.x) x [0, size.y) with Bridson's algorithm, trying the candidates
+// around a random active point as in Martin Roberts' variant: evenly spaced on the circle just
+// outside its radius r, from a random angle, instead of at random in the annulus [r, 2r)
+// this packs the points tighter and needs no rejection sampling, a point stops being active
+// after attempt_count misses
+// no two points are closer than min_radius, which is the diagonal of the cells of the background
+// grid, so every cell holds at most one point and a test only reads the cells around the candidate
+// the weighted variants take the radius of every point from a density in [0, 1], from max_radius
+// where it is 0 to min_radius where it is 1, and keep a candidate only if no point is closer than
+// its own radius
+// the points only depend on the seed and on the parameters, the buffers are reused between calls
+template<std::floating_point T>
+class basic_poisson_disk_sampler
+{
+public:
+    using value_type = T;
+    using vec2_type = basic_vec2<T>;
+
+    static constexpr std::size_t default_attempt_count = 20;
+
+public:
+    basic_poisson_disk_sampler(vec2_type size, value_type radius)
+        : basic_poisson_disk_sampler(size, radius, radius)
+    {}
+
+    basic_poisson_disk_sampler(vec2_type size, value_type min_radius, value_type max_radius)
+        : m_size{ size }
+        , m_min_radius{ min_radius }
+        , m_max_radius{ max_radius }
+        , m_cell_size{ min_radius / std::numbers::sqrt2_v<value_type> }
+    {
+        FLOW_ASSERT(size.x > value_type{ 0 } && size.y > value_type{ 0 }, "the sampled area is empty");
+        FLOW_ASSERT(min_radius > value_type{ 0 } && min_radius <= max_radius, "invalid radii");
+
+        m_columns = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(size.x / m_cell_size)));
+        m_rows = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(size.y / m_cell_size)));
+
+        set_attempt_count(default_attempt_count);
+    }
+
+    // more attempts leave fewer gaps and take longer
+    void set_attempt_count(std::size_t attempt_count)
+    {
+        FLOW_ASSERT(attempt_count > 0, "attempt count must be positive");
+
+        const value_type step = std::numbers::pi_v<value_type> * value_type{ 2 } / static_cast<value_type>(attempt_count);
+
+        m_attempt_count = attempt_count;
+        m_rotation = { std::cos(step), std::sin(step) };
+    }
+
+    // every point at min_radius from the others
+    std::span<const vec2_type> generate(std::uint64_t seed)
+    {
+        run(seed, [this](const vec2_type&) { return m_min_radius; });
+        return m_points;
+    }
+
+    // density(point) in [0, 1], values outside are clamped
+    template<std::invocable<const vec2_type&> DensityF>
+    std::span<const vec2_type> generate(std::uint64_t seed, DensityF&& density)
+    {
+        const value_type range = m_max_radius - m_min_radius;
+
+        run(seed, [&](const vec2_type& point) {
+            return m_max_radius - std::clamp(static_cast<value_type>(density(point)), value_type{ 0 }, value_type{ 1 }) * range;
+        });
+
+        return m_points;
+    }
+
+    // density(point) = (noise(point * frequency) + 1) / 2
+    template<typename GeneratorT>
+    std::span<const vec2_type> generate(std::uint64_t seed, const basic_noise_generator<GeneratorT>& noise, value_type frequency)
+    {
+        using noise_value_type = typename basic_noise_generator<GeneratorT>::value_type;
+
+        return generate(seed, [&](const vec2_type& point) {
+            const auto value = static_cast<value_type>(noise(static_cast<noise_value_type>(point.x * frequency),
+                                                             static_cast<noise_value_type>(point.y * frequency)));
+
+            return (value + value_type{ 1 }) * value_type{ 0.5 };
+        });
+    }
+
+    // the points of the last call to generate, in the order they were found
+    [[nodiscard]] std::span<const vec2_type> points() const noexcept
+    {
+        return m_points;
+    }
+
+    [[nodiscard]] constexpr vec2_type size() const noexcept
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr value_type min_radius() const noexcept
+    {
+        return m_min_radius;
+    }
+
+    [[nodiscard]] constexpr value_type max_radius() const noexcept
+    {
+        return m_max_radius;
+    }
+
+    [[nodiscard]] constexpr std::size_t attempt_count() const noexcept
+    {
+        return m_attempt_count;
+    }
+
+private:
+    // its squared distance to any candidate overflows to infinity, so empty cells need no branch
+    static constexpr vec2_type empty_cell{ std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::max() };
+
+    static constexpr value_type epsilon = 1e-3;
+
+    struct active_point
+    {
+        vec2_type point;
+        value_type radius;
+    };
+
+    template<typename RadiusF>
+    void run(std::uint64_t seed, RadiusF&& radius_at)
+    {
+        m_points.clear();
+        m_active.clear();
+        m_grid.assign(m_columns * m_rows, empty_cell);
+
+        random_generator generator(seed);
+
+        const vec2_type first{ generator.next<value_type>() * m_size.x, generator.next<value_type>() * m_size.y };
+        add(first, radius_at(first));
+
+        while (!m_active.empty())
+        {
+            const auto slot = static_cast<std::size_t>(detail::mul_high(generator(), m_active.size()));
+            const auto [center, radius] = m_active[slot];
+
+            // the candidates go around the circle of radius (1 + epsilon) * radius, from a random angle
+            const value_type angle = generator.next<value_type>() * std::numbers::pi_v<value_type> * value_type{ 2 };
+            const value_type distance = radius * (value_type{ 1 } + epsilon);
+            vec2_type direction{ std::cos(angle), std::sin(angle) };
+
+            bool found = false;
+
+            for (std::size_t attempt = 0; attempt < m_attempt_count && !found; ++attempt)
+            {
+                vec2_type candidate = center + direction * distance;
+
+                direction = { direction.x * m_rotation.x - direction.y * m_rotation.y,
+                              direction.x * m_rotation.y + direction.y * m_rotation.x };
+
+                if (!contains(candidate))
+                {
+                    continue;
+                }
+
+                value_type candidate_radius = radius_at(candidate);
+
+                // towards sparser areas the center would be too close, so the candidate moves out
+                if (candidate_radius > radius)
+                {
+                    candidate = center + (candidate - center) * (candidate_radius / radius);
+
+                    if (!contains(candidate))
+                    {
+                        continue;
+                    }
+
+                    candidate_radius = radius_at(candidate);
+                }
+
+                if (is_free(candidate, candidate_radius))
+                {
+                    add(candidate, candidate_radius);
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                m_active[slot] = m_active.back();
+                m_active.pop_back();
+            }
+        }
+    }
+
+    [[nodiscard]] bool contains(const vec2_type& point) const noexcept
+    {
+        return point.x >= value_type{ 0 } && point.y >= value_type{ 0 } && point.x < m_size.x && point.y < m_size.y;
+    }
+
+    [[nodiscard]] std::size_t column_of(value_type x) const noexcept
+    {
+        return std::min(static_cast<std::size_t>(x / m_cell_size), m_columns - 1);
+    }
+
+    [[nodiscard]] std::size_t row_of(value_type y) const noexcept
+    {
+        return std::min(static_cast<std::size_t>(y / m_cell_size), m_rows - 1);
+    }
+
+    // no point closer than radius, the cells next to the candidate reject most candidates,
+    // so they are read first
+    [[nodiscard]] bool is_free(const vec2_type& candidate, value_type radius) const noexcept
+    {
+        const auto reach = static_cast<std::size_t>(std::ceil(radius / m_cell_size));
+
+        const std::size_t column = column_of(candidate.x);
+        const std::size_t row = row_of(candidate.y);
+        const value_type radius2 = radius * radius;
+
+        return is_free(candidate, radius2, column, row, 1)
+            && (reach <= 1 || is_free(candidate, radius2, column, row, reach));
+    }
+
+    // no point closer than sqrt(radius2) within reach cells of (column, row)
+    [[nodiscard]] bool is_free(const vec2_type& candidate, value_type radius2, std::size_t column, std::size_t row, std::size_t reach) const noexcept
+    {
+        const std::size_t first_column = column > reach ? column - reach : 0;
+        const std::size_t last_column = std::min(column + reach, m_columns - 1);
+        const std::size_t first_row = row > reach ? row - reach : 0;
+        const std::size_t last_row = std::min(row + reach, m_rows - 1);
+
+        for (std::size_t y = first_row; y <= last_row; ++y)
+        {
+            const vec2_type* cells = m_grid.data() + y * m_columns;
+
+            for (std::size_t x = first_column; x <= last_column; ++x)
+            {
+                if (distance2(cells[x], candidate) < radius2)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void add(const vec2_type& point, value_type radius)
+    {
+        m_points.push_back(point);
+        m_active.push_back({ point, radius });
+        m_grid[row_of(point.y) * m_columns + column_of(point.x)] = point;
+    }
+
+private:
+    vec2_type m_size;
+    value_type m_min_radius;
+    value_type m_max_radius;
+    std::size_t m_attempt_count{};
+
+    value_type m_cell_size;
+    std::size_t m_columns{};
+    std::size_t m_rows{};
+    vec2_type m_rotation{}; // cos and sin of the angle between two candidates
+
+    std::vector<vec2_type> m_points{};
+    std::vector<active_point> m_active{}; // the points that can still get neighbours
+    std::vector<vec2_type> m_grid{};      // the point in every cell, row by row
+};
+
+using poisson_disk_sampler = basic_poisson_disk_sampler<float>;
+
+} // namespace flow
@@ -1,14 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <random>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include "../core/assertion.hpp"
+#include "../core/defines.hpp"
 #include "concepts.hpp"
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#elif defined(FLOW_COMPILER_MSVC)
+#  include <intrin.h>
+#endif
+
 namespace flow {
 
 // based on Sebastiano Vigna's implementation
@@ -51,6 +65,98 @@ private:
     state_type m_state;
 };
 
+namespace detail {
+
+    // the xoshiro256 state after n steps is p(T) applied to the state, where T is one step and
+    // p is x^n modulo the characteristic polynomial of T, bit i holds the coefficient of x^i
+    using xoshiro256_polynomial = std::array<std::uint64_t, 4>;
+
+    // the characteristic polynomial, without its x^256 term
+    inline constexpr xoshiro256_polynomial xoshiro256_characteristic_polynomial{
+        0x9d116f2bb0f0f001,
+        0x0280002bcefd1a5e,
+        0x04b4edcf26259f85,
+        0x0003c03c3f3ecb19
+    };
+
+    // x^(2^128)
+    inline constexpr xoshiro256_polynomial xoshiro256_jump_polynomial{
+        0x180ec6d33cfd0aba,
+        0xd5a61266f0c9392c,
+        0xa9582618e03fc9aa,
+        0x39abdc4529b1661c
+    };
+
+    // x^(2^192)
+    inline constexpr xoshiro256_polynomial xoshiro256_long_jump_polynomial{
+        0x76e15d3efefdcbbf,
+        0xc5004e441c522fb3,
+        0x77710069854ee241,
+        0x39109bb02acbe635
+    };
+
+    [[nodiscard]] constexpr xoshiro256_polynomial multiply_by_x(xoshiro256_polynomial p) noexcept
+    {
+        const bool overflow = (p[3] >> 63) != 0;
+
+        for (std::size_t i = p.size() - 1; i > 0; --i)
+        {
+            p[i] = (p[i] << 1) | (p[i - 1] >> 63);
+        }
+        p[0] <<= 1;
+
+        if (overflow)
+        {
+            for (std::size_t i = 0; i < p.size(); ++i)
+            {
+                p[i] ^= xoshiro256_characteristic_polynomial[i];
+            }
+        }
+
+        return p;
+    }
+
+    // a * b modulo the characteristic polynomial
+    [[nodiscard]] constexpr xoshiro256_polynomial multiply(const xoshiro256_polynomial& a, const xoshiro256_polynomial& b) noexcept
+    {
+        xoshiro256_polynomial result{};
+
+        for (std::size_t bit = 256; bit-- > 0;)
+        {
+            result = multiply_by_x(result);
+
+            if ((b[bit / 64] >> (bit % 64)) & 1)
+            {
+                for (std::size_t i = 0; i < result.size(); ++i)
+                {
+                    result[i] ^= a[i];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // x^(2^(192 + i)), the polynomial of 2^i long jumps, computed once, on first use
+    [[nodiscard]] inline const std::array<xoshiro256_polynomial, 64>& get_long_jump_polynomials() noexcept
+    {
+        static const auto polynomials = [] {
+            std::array<xoshiro256_polynomial, 64> result{};
+            result[0] = xoshiro256_long_jump_polynomial;
+
+            for (std::size_t i = 1; i < result.size(); ++i)
+            {
+                result[i] = multiply(result[i - 1], result[i - 1]);
+            }
+
+            return result;
+        }();
+
+        return polynomials;
+    }
+
+} // namespace detail
+
 // based on David Blackman and Sebastiano Vigna's implementation
 // https://prng.di.unimi.it/xoshiro256plusplus.c
 class xoshiro256pp
@@ -94,53 +200,58 @@ public:
 
     constexpr void jump() noexcept
     {
-        using jump_type = state_type::value_type;
+        jump(detail::xoshiro256_jump_polynomial);
+    }
 
-        constexpr std::array<jump_type, 4> jump_state{
-            0x180ec6d33cfd0aba,
-            0xd5a61266f0c9392c,
-            0xa9582618e03fc9aa,
-            0x39abdc4529b1661c
-        };
+    constexpr void long_jump() noexcept
+    {
+        jump(detail::xoshiro256_long_jump_polynomial);
+    }
 
-        constexpr std::size_t jump_bit_count = sizeof(jump_type) * 8;
+    // count long jumps at the cost of one, plus a product of polynomials for every bit of count
+    void long_jump(std::uint64_t count) noexcept
+    {
+        const auto& polynomials = detail::get_long_jump_polynomials();
 
-        state_type state{};
+        detail::xoshiro256_polynomial polynomial{ 1, 0, 0, 0 };
 
-        for (jump_type jump : jump_state)
+        for (std::size_t i = 0; count != 0; ++i, count >>= 1)
         {
-            for (std::size_t b = 0; b < jump_bit_count; ++b)
+            if (count & 1)
             {
-                if (jump & static_cast<jump_type>(1) << b)
-                {
-                    for (std::size_t i = 0; i < m_state.size(); ++i)
-                    {
-                        state[i] ^= m_state[i];
-                    }
-                }
-                std::ignore = operator()();
+                polynomial = detail::multiply(polynomial, polynomials[i]);
             }
         }
 
-        m_state.swap(state);
+        jump(polynomial);
     }
 
-    constexpr void long_jump() noexcept
+    [[nodiscard]] constexpr state_type state() const noexcept
     {
-        using jump_type = state_type::value_type;
+        return m_state;
+    }
 
-        constexpr std::array<jump_type, 4> jump_state{
-            0x76e15d3efefdcbbf,
-            0xc5004e441c522fb3,
-            0x77710069854ee241,
-            0x39109bb02acbe635
-        };
+    [[nodiscard]] static constexpr result_type min() noexcept
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    [[nodiscard]] static constexpr result_type max() noexcept
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    // the state after the number of steps the polynomial stands for
+    constexpr void jump(const detail::xoshiro256_polynomial& polynomial) noexcept
+    {
+        using jump_type = state_type::value_type;
 
         constexpr std::size_t jump_bit_count = sizeof(jump_type) * 8;
 
         state_type state{};
 
-        for (jump_type jump : jump_state)
+        for (jump_type jump : polynomial)
         {
             for (std::size_t b = 0; b < jump_bit_count; ++b)
             {
@@ -158,9 +269,110 @@ public:
         m_state.swap(state);
     }
 
-    [[nodiscard]] constexpr state_type state() const noexcept
+private:
+    state_type m_state;
+};
+
+namespace detail {
+
+    [[nodiscard]] inline std::uint64_t mul_high(std::uint64_t a, std::uint64_t b) noexcept
     {
-        return m_state;
+#if defined(FLOW_COMPILER_MSVC)
+        return __umulh(a, b);
+#else
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#endif
+    }
+
+} // namespace detail
+
+// LaneCount independent xoshiro256pp generators stepped together, for filling large spans
+// lane i starts i jumps (2^128 steps) after xoshiro256pp(seed), and the values are
+// interleaved lane by lane, so the sequence only depends on the seed and on LaneCount,
+// not on how it is split between fill calls
+// the range mappings are branch free: integers use Lemire's multiply-shift without
+// rejection, which is biased by at most range / 2^64
+template<std::size_t LaneCount = 4>
+    requires(LaneCount > 0 && LaneCount % 4 == 0)
+class xoshiro256pp_lanes
+{
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr std::size_t lane_count = LaneCount;
+
+public:
+    explicit xoshiro256pp_lanes(std::uint64_t seed = 0) noexcept
+    {
+        xoshiro256pp generator(seed);
+
+        for (std::size_t lane = 0; lane < lane_count; ++lane)
+        {
+            const xoshiro256pp::state_type state = generator.state();
+
+            for (std::size_t i = 0; i < state.size(); ++i)
+            {
+                m_state[i][lane] = state[i];
+            }
+
+            generator.jump();
+        }
+    }
+
+    [[nodiscard]] result_type operator()() noexcept
+    {
+        if (m_block_index == lane_count)
+        {
+            step(m_block.data());
+            m_block_index = 0;
+        }
+
+        return m_block[m_block_index++];
+    }
+
+    void fill(std::span<std::uint64_t> values) noexcept
+    {
+        generate(values, [](std::uint64_t x) { return x; });
+    }
+
+    // uniform in [0, 1)
+    template<std::floating_point T>
+    void fill(std::span<T> values) noexcept
+    {
+        generate(values, [](std::uint64_t x) { return to_unit<T>(x); });
+    }
+
+    // uniform in [min, max), min + unit * range can round up to max, so it is clamped
+    // to the value below it
+    template<std::floating_point T>
+    void fill(std::span<T> values, T min, T max) noexcept
+    {
+        const T range = max - min;
+        const T last = std::nextafter(max, min);
+        generate(values, [=](std::uint64_t x) { return std::min(min + to_unit<T>(x) * range, last); });
+    }
+
+    // uniform in [min, max]
+    template<concepts::non_boolean_arithmetic T>
+        requires std::integral<T>
+    void fill(std::span<T> values, T min, T max) noexcept
+    {
+        using unsigned_type = std::make_unsigned_t<T>;
+
+        // 0 stands for the full 2^64 range
+        const std::uint64_t range = static_cast<std::uint64_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(max) - static_cast<unsigned_type>(min))) + 1;
+
+        if (range == 0)
+        {
+            generate(values, [](std::uint64_t x) { return static_cast<T>(x); });
+        }
+        else
+        {
+            generate(values, [=](std::uint64_t x) {
+                return static_cast<T>(static_cast<unsigned_type>(min)
+                                      + static_cast<unsigned_type>(detail::mul_high(x, range)));
+            });
+        }
     }
 
     [[nodiscard]] static constexpr result_type min() noexcept
@@ -174,7 +386,358 @@ public:
     }
 
 private:
-    state_type m_state;
+    static constexpr std::size_t batch_size = 256; // values generated before mapping them
+
+    template<std::floating_point T>
+    [[nodiscard]] static constexpr T to_unit(std::uint64_t x) noexcept
+    {
+        if constexpr (sizeof(T) == sizeof(float))
+        {
+            return static_cast<T>(static_cast<std::uint32_t>(x >> 40)) * 0x1.0p-24f;
+        }
+        else
+        {
+            return static_cast<T>(x >> 11) * 0x1.0p-53;
+        }
+    }
+
+    template<typename T, typename MapT>
+    void generate(std::span<T> values, MapT map) noexcept
+    {
+        // values left over from operator() or from the last fill come first
+        while (!values.empty() && m_block_index < lane_count)
+        {
+            values.front() = map(m_block[m_block_index++]);
+            values = values.subspan(1);
+        }
+
+        alignas(32) std::array<std::uint64_t, batch_size> batch;
+
+        while (values.size() >= lane_count)
+        {
+            const std::size_t count = std::min(values.size(), batch.size()) / lane_count * lane_count;
+
+            for (std::size_t i = 0; i < count; i += lane_count)
+            {
+                step(batch.data() + i);
+            }
+
+            std::transform(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(count), values.begin(), map);
+            values = values.subspan(count);
+        }
+
+        if (!values.empty())
+        {
+            step(m_block.data());
+            std::transform(m_block.begin(), m_block.begin() + static_cast<std::ptrdiff_t>(values.size()), values.begin(), map);
+            m_block_index = values.size();
+        }
+    }
+
+    // writes the next value of every lane to out
+    void step(std::uint64_t* out) noexcept
+    {
+#if defined(__AVX2__)
+        // NOLINTBEGIN(*-reinterpret-cast)
+        for (std::size_t lane = 0; lane < lane_count; lane += 4)
+        {
+            auto* s0_ptr = reinterpret_cast<__m256i*>(m_state[0].data() + lane);
+            auto* s1_ptr = reinterpret_cast<__m256i*>(m_state[1].data() + lane);
+            auto* s2_ptr = reinterpret_cast<__m256i*>(m_state[2].data() + lane);
+            auto* s3_ptr = reinterpret_cast<__m256i*>(m_state[3].data() + lane);
+
+            __m256i s0 = _mm256_load_si256(s0_ptr);
+            __m256i s1 = _mm256_load_si256(s1_ptr);
+            __m256i s2 = _mm256_load_si256(s2_ptr);
+            __m256i s3 = _mm256_load_si256(s3_ptr);
+
+            const __m256i sum = _mm256_add_epi64(s0, s3);
+            const __m256i rotated = _mm256_or_si256(_mm256_slli_epi64(sum, 23), _mm256_srli_epi64(sum, 41));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + lane), _mm256_add_epi64(rotated, s0));
+
+            const __m256i t = _mm256_slli_epi64(s1, 17);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+
+            _mm256_store_si256(s0_ptr, s0);
+            _mm256_store_si256(s1_ptr, s1);
+            _mm256_store_si256(s2_ptr, s2);
+            _mm256_store_si256(s3_ptr, s3);
+        }
+        // NOLINTEND(*-reinterpret-cast)
+#else
+        // laid out so that compilers can vectorize it
+        auto& [s0, s1, s2, s3] = m_state;
+
+        for (std::size_t lane = 0; lane < lane_count; ++lane)
+        {
+            out[lane] = std::rotl(s0[lane] + s3[lane], 23) + s0[lane];
+
+            const std::uint64_t t = s1[lane] << 17;
+
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = std::rotl(s3[lane], 45);
+        }
+#endif
+    }
+
+private:
+    // the i-th word of the state of every lane is contiguous
+    alignas(32) std::array<std::array<std::uint64_t, lane_count>, 4> m_state{};
+    std::array<std::uint64_t, lane_count> m_block{};
+    std::size_t m_block_index{ lane_count };
+};
+
+// draws indices in [0, size) with probabilities proportional to the weights it was built
+// from, in O(1) with Vose's alias method
+// a single 64 bit value picks both the column (its high product with the size, as in
+// Lemire's multiply-shift) and the coin of the column (the low product), so the
+// probabilities are exact up to 2^-32 for tables of up to 2^32 entries
+class alias_table
+{
+public:
+    alias_table() = default;
+
+    // the weights must be non-negative with a positive sum
+    template<concepts::non_boolean_arithmetic T>
+    explicit alias_table(std::span<const T> weights)
+    {
+        FLOW_ASSERT(!weights.empty() && weights.size() <= std::numeric_limits<std::uint32_t>::max(), "invalid weight count");
+
+        double sum = 0.0;
+
+        for (const T weight : weights)
+        {
+            FLOW_ASSERT(weight >= T{ 0 }, "negative weight");
+            sum += static_cast<double>(weight);
+        }
+
+        FLOW_ASSERT(sum > 0.0, "the weights sum to zero");
+
+        const std::size_t n = weights.size();
+        const double scale = static_cast<double>(n) / sum;
+
+        std::vector<double> probabilities(n);
+        std::vector<std::uint32_t> small{};
+        std::vector<std::uint32_t> large{};
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            probabilities[i] = static_cast<double>(weights[i]) * scale;
+            (probabilities[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+        }
+
+        m_columns.resize(n);
+
+        while (!small.empty() && !large.empty())
+        {
+            const std::uint32_t less = small.back();
+            const std::uint32_t more = large.back();
+            small.pop_back();
+            large.pop_back();
+
+            m_columns[less] = { to_threshold(probabilities[less]), more };
+
+            probabilities[more] = (probabilities[more] + probabilities[less]) - 1.0;
+            (probabilities[more] < 1.0 ? small : large).push_back(more);
+        }
+
+        // what is left is full up to rounding
+        large.insert(large.end(), small.begin(), small.end());
+
+        for (const std::uint32_t i : large)
+        {
+            m_columns[i] = { std::numeric_limits<std::uint64_t>::max(), i };
+        }
+    }
+
+    template<concepts::non_boolean_arithmetic T>
+    explicit alias_table(const std::vector<T>& weights)
+        : alias_table(std::span<const T>(weights))
+    {}
+
+    template<typename G>
+    [[nodiscard]] std::size_t operator()(G& generator) const
+    {
+        static_assert(sizeof(typename G::result_type) == sizeof(std::uint64_t), "alias_table needs 64 bit values");
+        FLOW_ASSERT(!m_columns.empty(), "sampling an empty alias_table");
+
+        const auto value = static_cast<std::uint64_t>(generator());
+        const std::uint64_t size = m_columns.size();
+
+        const auto index = static_cast<std::size_t>(detail::mul_high(value, size));
+        const column& picked = m_columns[index];
+
+        return value * size < picked.threshold ? index : picked.alias;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_columns.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_columns.empty();
+    }
+
+private:
+    struct column
+    {
+        std::uint64_t threshold; // the column keeps its index below it
+        std::uint32_t alias;
+    };
+
+    [[nodiscard]] static std::uint64_t to_threshold(double probability) noexcept
+    {
+        const double threshold = std::ldexp(probability, 64);
+
+        return threshold >= 0x1.0p64 ? std::numeric_limits<std::uint64_t>::max() : static_cast<std::uint64_t>(threshold);
+    }
+
+private:
+    std::vector<column> m_columns{};
+};
+
+namespace detail {
+
+    // Marsaglia and Tsang's ziggurat with 256 layers of equal area under exp(-x^2 / 2)
+    // layer i spans [0, x[i]) horizontally and [f[i], f[i + 1]) vertically, x[1] is where
+    // the tail starts and layer 0 is the base, a rectangle of the same area as the others
+    // holding the tail
+    struct ziggurat_normal_table
+    {
+        static constexpr std::size_t layer_count = 256;
+        static constexpr double tail_start = 3.6541528853610088;
+        static constexpr double layer_area = 0.00492867323399;
+
+        std::array<double, layer_count + 1> x;
+        std::array<double, layer_count + 1> f;
+
+        ziggurat_normal_table() noexcept
+        {
+            const auto density = [](double v) { return std::exp(-0.5 * v * v); };
+
+            x[0] = layer_area / density(tail_start);
+            x[1] = tail_start;
+
+            for (std::size_t i = 1; i < layer_count - 1; ++i)
+            {
+                x[i + 1] = std::sqrt(-2.0 * std::log(layer_area / x[i] + density(x[i])));
+            }
+
+            x[layer_count] = 0.0;
+
+            for (std::size_t i = 0; i <= layer_count; ++i)
+            {
+                f[i] = density(x[i]);
+            }
+        }
+    };
+
+    // computed once, on first use
+    [[nodiscard]] inline const ziggurat_normal_table& get_ziggurat_normal_table() noexcept
+    {
+        static const ziggurat_normal_table table{};
+        return table;
+    }
+
+    // in (0, 1], so that it can go in a logarithm
+    [[nodiscard]] constexpr double to_positive_unit(std::uint64_t x) noexcept
+    {
+        return static_cast<double>((x >> 11) + 1) * 0x1.0p-53;
+    }
+
+    // a standard normal value, about 99% of the calls take one 64 bit value and no
+    // transcendental function: the low 8 bits pick the layer, the 9th the sign and the
+    // high 53 the position in the layer
+    template<typename G>
+    [[nodiscard]] double ziggurat_normal(G& generator)
+    {
+        static_assert(sizeof(typename G::result_type) == sizeof(std::uint64_t), "the ziggurat needs 64 bit values");
+
+        const ziggurat_normal_table& table = get_ziggurat_normal_table();
+
+        while (true)
+        {
+            const auto bits = static_cast<std::uint64_t>(generator());
+
+            const std::size_t layer = bits & 0xff;
+            const double sign = (bits & 0x100) != 0 ? -1.0 : 1.0;
+            const double x = static_cast<double>(bits >> 11) * 0x1.0p-53 * table.x[layer];
+
+            if (x < table.x[layer + 1])
+            {
+                return sign * x;
+            }
+
+            if (layer == 0)
+            {
+                double a{};
+                double b{};
+
+                do
+                {
+                    a = -std::log(to_positive_unit(static_cast<std::uint64_t>(generator()))) / ziggurat_normal_table::tail_start;
+                    b = -std::log(to_positive_unit(static_cast<std::uint64_t>(generator())));
+                } while (b + b < a * a);
+
+                return sign * (ziggurat_normal_table::tail_start + a);
+            }
+
+            const double y = table.f[layer] + static_cast<double>(static_cast<std::uint64_t>(generator()) >> 11) * 0x1.0p-53 * (table.f[layer + 1] - table.f[layer]);
+
+            if (y < std::exp(-0.5 * x * x))
+            {
+                return sign * x;
+            }
+        }
+    }
+
+} // namespace detail
+
+// normal distribution sampled with a precomputed ziggurat, a drop-in for
+// std::normal_distribution with any generator of 64 bit values
+template<std::floating_point T = double>
+class ziggurat_normal_distribution
+{
+public:
+    using result_type = T;
+
+public:
+    explicit constexpr ziggurat_normal_distribution(T mean = T{ 0 }, T stddev = T{ 1 }) noexcept
+        : m_mean{ mean }
+        , m_stddev{ stddev }
+    {}
+
+    template<typename G>
+    [[nodiscard]] T operator()(G& generator) const
+    {
+        return m_mean + m_stddev * static_cast<T>(detail::ziggurat_normal(generator));
+    }
+
+    [[nodiscard]] constexpr T mean() const noexcept
+    {
+        return m_mean;
+    }
+
+    [[nodiscard]] constexpr T stddev() const noexcept
+    {
+        return m_stddev;
+    }
+
+private:
+    T m_mean;
+    T m_stddev;
 };
 
 // TODO: find a way to make constexpr the methods of the
@@ -193,6 +756,10 @@ public:
         : m_generator(seed)
     {}
 
+    explicit constexpr basic_random_generator(generator_type generator) noexcept(std::is_nothrow_move_constructible_v<generator_type>)
+        : m_generator(std::move(generator))
+    {}
+
     template<concepts::arithmetic T = result_type>
     [[nodiscard]] constexpr T operator()() noexcept(concepts::nothrow_operator_callable<generator_type>)
     {
@@ -268,6 +835,75 @@ public:
         return std::bernoulli_distribution(p)(*this);
     }
 
+    // normal distribution through the ziggurat
+    template<std::floating_point T = double>
+    [[nodiscard]] T normal(T mean = T{ 0 }, T stddev = T{ 1 })
+    {
+        return ziggurat_normal_distribution<T>(mean, stddev)(m_generator);
+    }
+
+    // an index of the table, with the probability of its weight
+    [[nodiscard]] std::size_t pick(const alias_table& table)
+    {
+        return table(m_generator);
+    }
+
+    // a value of any distribution callable with a generator, like the std ones,
+    // alias_table or ziggurat_normal_distribution
+    template<typename DistributionT>
+    [[nodiscard]] auto sample(DistributionT&& distribution)
+    {
+        return distribution(*this);
+    }
+
+    // fills values with draws of the distribution, in order
+    template<typename T, typename DistributionT>
+    void sample_n(std::span<T> values, DistributionT&& distribution)
+    {
+        for (auto& value : values)
+        {
+            value = static_cast<T>(distribution(*this));
+        }
+    }
+
+    template<typename T>
+    void normal_n(std::span<T> values, T mean = T{ 0 }, T stddev = T{ 1 })
+    {
+        sample_n(values, ziggurat_normal_distribution<T>(mean, stddev));
+    }
+
+    template<typename T>
+    void pick_n(std::span<T> indices, const alias_table& table)
+    {
+        sample_n(indices, table);
+    }
+
+    // Fisher-Yates with the indices reduced by mul_high, unlike std::shuffle the order
+    // only depends on the generator, not on the standard library
+    template<typename T>
+    void shuffle(std::span<T> values) noexcept(concepts::nothrow_operator_callable<generator_type>)
+    {
+        for (std::size_t i = values.size(); i > 1; --i)
+        {
+            const auto j = static_cast<std::size_t>(detail::mul_high(next<std::uint64_t>(), i));
+            std::swap(values[i - 1], values[j]);
+        }
+    }
+
+    // uniform in [min, max], like uniform
+    template<concepts::non_boolean_arithmetic T>
+    void uniform_n(std::span<T> values, T min, T max)
+    {
+        if constexpr (std::floating_point<T>)
+        {
+            sample_n(values, std::uniform_real_distribution<T>(min, max));
+        }
+        else
+        {
+            sample_n(values, std::uniform_int_distribution<T>(min, max));
+        }
+    }
+
     template<concepts::non_boolean_arithmetic T = result_type>
     [[nodiscard]] constexpr std::vector<T> sequence(std::size_t n)
     {
@@ -387,10 +1023,112 @@ public:
         return std::numeric_limits<T>::max();
     }
 
+    [[nodiscard]] constexpr const generator_type& generator() const noexcept
+    {
+        return m_generator;
+    }
+
 private:
     generator_type m_generator;
 };
 
 using random_generator = basic_random_generator<xoshiro256pp>;
 
+// derives non-overlapping random generators from a single seed, to hand to parallel jobs:
+// the i-th generator starts i jumps (2^128 values) after random_generator(seed), so
+// which generator a job gets only depends on its index, not on the thread that runs it
+// every factory owns a range of 2^192 values, split hands out the ranges of a tree: the ranges
+// are numbered with one 16 bit digit per level of nesting, the k-th split of a factory at depth d
+// sets digit d to k, so factories nest up to max_split_depth levels, with up to max_split_count
+// splits each, and no two of them start in the same range
+// note that xoshiro256pp_lanes(seed) overlaps with the generators of the same seed
+class random_stream_factory
+{
+public:
+    static constexpr std::size_t max_split_depth = 4;
+    static constexpr std::uint64_t max_split_count = 0xffff;
+
+public:
+    explicit constexpr random_stream_factory(std::uint64_t seed = 0) noexcept
+        : m_base(seed)
+        , m_next(m_base)
+    {}
+
+    explicit constexpr random_stream_factory(xoshiro256pp base) noexcept
+        : m_base(base)
+        , m_next(base)
+    {}
+
+    // the generator after the last one returned by next
+    [[nodiscard]] constexpr random_generator next() noexcept
+    {
+        const xoshiro256pp generator = m_next;
+        m_next.jump();
+        return random_generator(generator);
+    }
+
+    // the next count generators, one for each job
+    [[nodiscard]] std::vector<random_generator> next(std::size_t count)
+    {
+        std::vector<random_generator> generators{};
+        generators.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            generators.push_back(next());
+        }
+
+        return generators;
+    }
+
+    // the index-th generator, regardless of the calls to next, takes index jumps
+    [[nodiscard]] constexpr random_generator at(std::size_t index) const noexcept
+    {
+        xoshiro256pp generator = m_base;
+
+        for (std::size_t i = 0; i < index; ++i)
+        {
+            generator.jump();
+        }
+
+        return random_generator(generator);
+    }
+
+    // a factory whose generators don't overlap with the ones of this factory, nor with the ones
+    // of any other factory split from the same root, however deep
+    [[nodiscard]] random_stream_factory split() noexcept
+    {
+        FLOW_ASSERT(m_depth < max_split_depth, "random stream factories nested too deep");
+        FLOW_ASSERT(m_split_count < max_split_count, "too many splits of a random stream factory");
+
+        ++m_split_count;
+
+        xoshiro256pp base = m_base;
+        base.long_jump(m_split_count << (split_digit_bit_count * (max_split_depth - 1 - m_depth)));
+
+        return random_stream_factory(base, m_depth + 1);
+    }
+
+    // the number of splits between this factory and the root
+    [[nodiscard]] constexpr std::size_t depth() const noexcept
+    {
+        return m_depth;
+    }
+
+private:
+    static constexpr std::size_t split_digit_bit_count = 16;
+
+    constexpr random_stream_factory(xoshiro256pp base, std::size_t depth) noexcept
+        : m_base(base)
+        , m_next(base)
+        , m_depth{ depth }
+    {}
+
+private:
+    xoshiro256pp m_base;
+    xoshiro256pp m_next;
+    std::uint64_t m_split_count{};
+    std::size_t m_depth{};
+};
+
 } // namespace flow
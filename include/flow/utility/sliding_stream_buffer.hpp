@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <span>
 #include <vector>
 
+#include "../core/assertion.hpp"
 #include "concepts.hpp"
 #include "istream_view.hpp"
 #include "ostream_view.hpp"
@@ -12,6 +15,10 @@
 
 namespace flow {
 
+// loading a window that overlaps the previously loaded one only reads the newly exposed values,
+// and saving only writes the values that were accessed through the mutable values() overloads
+// the reused values assume every load reads the same stream, and that nothing else writes the
+// loaded range of it, otherwise use reload(), or invalidate() before the next load
 template<concepts::trivially_copyable T, std::unsigned_integral SizeT = std::size_t>
 class sliding_stream_buffer
 {
@@ -57,6 +64,7 @@ public:
                                           buffer_element_count);
 
         m_buffer.resize(m_sliding_window.size());
+        reset_loaded();
     }
 
     constexpr void create(size_type stream_start_position,
@@ -72,6 +80,7 @@ public:
                                           buffer_begin_index);
 
         m_buffer.resize(m_sliding_window.size());
+        reset_loaded();
     }
 
     constexpr size_type forward(size_type count) noexcept
@@ -164,38 +173,162 @@ public:
         return bounds_size() * sizeof(value_type);
     }
 
+    // marks all the values as dirty
     [[nodiscard]] constexpr std::span<value_type> values() noexcept
     {
+        mark_dirty(0, static_cast<size_type>(m_buffer.size()));
         return m_buffer;
     }
 
+    // marks only the count values starting at first (relative to the window) as dirty
+    [[nodiscard]] constexpr std::span<value_type> values(size_type first, size_type count) noexcept
+    {
+        FLOW_ASSERT(first + count <= m_buffer.size(), "range out of bounds");
+
+        mark_dirty(first, count);
+        return std::span(m_buffer).subspan(first, count);
+    }
+
     [[nodiscard]] constexpr std::span<const value_type> values() const noexcept
     {
         return m_buffer;
     }
 
+    [[nodiscard]] constexpr bool is_dirty() const noexcept
+    {
+        return m_dirty_begin < m_dirty_end;
+    }
+
     constexpr void resize(size_type size)
     {
         m_sliding_window.resize(size);
         m_buffer.resize(m_sliding_window.size());
+
+        const auto buffer_size = static_cast<size_type>(m_buffer.size());
+        m_loaded_size = std::min(m_loaded_size, buffer_size);
+        m_dirty_begin = std::min(m_dirty_begin, buffer_size);
+        m_dirty_end = std::min(m_dirty_end, buffer_size);
     }
 
+    // the loaded values that are still inside the window are moved in place,
+    // along with their dirty state, and only the rest are read from the stream
+    // dirty values that left the window are discarded, so save before moving it
     void load(istream_view in)
     {
-        in.seek(stream_begin());
-        in.read(values());
+        const size_type window_begin = begin();
+        const size_type window_end = window_begin + static_cast<size_type>(m_buffer.size());
+        const size_type overlap_begin = std::max(window_begin, m_loaded_begin);
+        const size_type overlap_end = std::min(window_end, m_loaded_begin + m_loaded_size);
+
+        if (overlap_begin >= overlap_end)
+        {
+            m_dirty_begin = 0;
+            m_dirty_end = 0;
+
+            read(in, window_begin, window_end);
+        }
+        else
+        {
+            const size_type dirty_begin = std::max(m_loaded_begin + m_dirty_begin, overlap_begin);
+            const size_type dirty_end = std::min(m_loaded_begin + m_dirty_end, overlap_end);
+
+            m_dirty_begin = dirty_begin < dirty_end ? dirty_begin - window_begin : 0;
+            m_dirty_end = dirty_begin < dirty_end ? dirty_end - window_begin : 0;
+
+            if (window_begin != m_loaded_begin)
+            {
+                std::memmove(m_buffer.data() + (overlap_begin - window_begin),
+                             m_buffer.data() + (overlap_begin - m_loaded_begin),
+                             (overlap_end - overlap_begin) * sizeof(value_type));
+            }
+
+            read(in, window_begin, overlap_begin);
+            read(in, overlap_end, window_end);
+        }
+
+        // a failed read leaves the buffer partially loaded, so the next load reads it all
+        m_loaded_begin = window_begin;
+        m_loaded_size = in ? static_cast<size_type>(m_buffer.size()) : size_type{ 0 };
+    }
+
+    // reads the whole window again, the dirty values are discarded
+    void reload(istream_view in)
+    {
+        invalidate();
+        load(in);
     }
 
-    void save(ostream_view out) const
+    // forgets the loaded values and their dirty state, so the next load reads the whole window
+    constexpr void invalidate() noexcept
     {
-        out.seek(stream_begin());
-        out.write(values());
+        reset_loaded();
+    }
+
+    void save(ostream_view out)
+    {
+        if (!is_dirty())
+        {
+            return;
+        }
+
+        out.seek(stream_begin() + m_dirty_begin * sizeof(value_type));
+        out.write(std::span<const value_type>(m_buffer).subspan(m_dirty_begin, m_dirty_end - m_dirty_begin));
+
+        if (out)
+        {
+            m_dirty_begin = 0;
+            m_dirty_end = 0;
+        }
+    }
+
+private:
+    constexpr void mark_dirty(size_type first, size_type count) noexcept
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (is_dirty())
+        {
+            m_dirty_begin = std::min(m_dirty_begin, first);
+            m_dirty_end = std::max(m_dirty_end, first + count);
+        }
+        else
+        {
+            m_dirty_begin = first;
+            m_dirty_end = first + count;
+        }
+    }
+
+    constexpr void reset_loaded() noexcept
+    {
+        m_loaded_begin = 0;
+        m_loaded_size = 0;
+        m_dirty_begin = 0;
+        m_dirty_end = 0;
+    }
+
+    // reads the values in [first, last), given as indices into the stream elements
+    void read(istream_view in, size_type first, size_type last)
+    {
+        if (first >= last)
+        {
+            return;
+        }
+
+        in.seek(m_stream_start_position + first * sizeof(value_type));
+        in.read(std::span(m_buffer).subspan(first - begin(), last - first));
     }
 
 private:
     std::vector<value_type> m_buffer{};
     sliding_window<size_type> m_sliding_window{};
     size_type m_stream_start_position{};
+    size_type m_loaded_begin{};   // element index of the first loaded value
+    size_type m_loaded_size{};    // number of loaded values, 0 if nothing valid is loaded
+    size_type m_dirty_begin{};    // dirty range, relative to the buffer
+    size_type m_dirty_end{};
 };
 
 } // namespace flow
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <vector>
 
 #include "concepts.hpp"
 #include "istream_view.hpp"
@@ -27,6 +33,84 @@ namespace concepts {
                                };
 } // namespace concepts
 
+namespace detail {
+
+    // a random read is assumed to cost as much as reading this many bytes sequentially
+    inline constexpr std::size_t stream_random_read_cost = 4096;
+
+    inline constexpr std::size_t stream_merge_chunk_size = 1 << 16;
+
+    // a merge pass reads every value in the range once, while bisecting the range for every key,
+    // starting from the result of the previous key, takes about log2(n / k) random reads per key
+    [[nodiscard]] constexpr bool stream_prefer_merge(std::size_t value_count,
+                                                     std::size_t key_count,
+                                                     std::size_t value_size) noexcept
+    {
+        if (key_count == 0)
+        {
+            return false;
+        }
+
+        const std::size_t probes_per_key = std::bit_width(value_count / key_count) + 1;
+
+        return value_count * value_size <= key_count * probes_per_key * stream_random_read_cost;
+    }
+
+    // writes the index of the first value in [begin_index, end_index) for which is_before
+    // returns false, for every key, with a single pass of sequential chunked reads
+    template<typename CompValueT, concepts::trivially_copyable ValueT, std::output_iterator<std::size_t> OutputIt, typename PredicateT>
+    OutputIt stream_merge_bounds(istream_view in,
+                                 istream_view::pos_type start_position,
+                                 std::size_t begin_index,
+                                 std::size_t end_index,
+                                 std::span<const CompValueT> comp_values,
+                                 OutputIt out,
+                                 PredicateT is_before)
+    {
+        const std::size_t chunk_element_count = std::max<std::size_t>(stream_merge_chunk_size / sizeof(ValueT), 1);
+
+        std::vector<ValueT> chunk(std::min(chunk_element_count, end_index - begin_index));
+        std::size_t chunk_begin = begin_index;
+        std::size_t chunk_end = begin_index;
+        std::size_t index = begin_index;
+
+        for (const auto& comp_value : comp_values)
+        {
+            while (index < end_index)
+            {
+                if (index == chunk_end)
+                {
+                    const std::size_t count = std::min(chunk.size(), end_index - index);
+                    const auto position = start_position + static_cast<istream_view::off_type>(index * sizeof(ValueT));
+
+                    in.seek(position).read(std::span(chunk).first(count));
+
+                    if (!in)
+                    {
+                        index = end_index;
+                        break;
+                    }
+
+                    chunk_begin = index;
+                    chunk_end = index + count;
+                }
+
+                if (!is_before(chunk[index - chunk_begin], comp_value))
+                {
+                    break;
+                }
+
+                ++index;
+            }
+
+            *out++ = index;
+        }
+
+        return out;
+    }
+
+} // namespace detail
+
 template<typename CompValueT, concepts::trivially_copyable ValueT = CompValueT>
 std::size_t stream_lower_bound(istream_view in,
                                istream_view::pos_type start_position,
@@ -131,4 +215,111 @@ std::size_t stream_upper_bound(istream_view in,
     return stream_upper_bound(in, start_position, begin_index, end_index, comp_value, std::less{});
 }
 
+// writes stream_lower_bound of every value in comp_values, which must be sorted,
+// with a single sequential pass over the stream when the keys are dense enough,
+// or by bisecting the remaining range for every key when they are sparse
+template<typename CompValueT, concepts::trivially_copyable ValueT = CompValueT, std::output_iterator<std::size_t> OutputIt>
+OutputIt stream_lower_bounds(istream_view in,
+                             istream_view::pos_type start_position,
+                             std::size_t begin_index,
+                             std::size_t end_index,
+                             std::span<const CompValueT> comp_values,
+                             OutputIt out,
+                             concepts::left_comparator<ValueT, CompValueT> auto compare)
+{
+    if (begin_index < end_index
+        && detail::stream_prefer_merge(end_index - begin_index, comp_values.size(), sizeof(ValueT)))
+    {
+        return detail::stream_merge_bounds<CompValueT, ValueT>(
+            in,
+            start_position,
+            begin_index,
+            end_index,
+            comp_values,
+            out,
+            [&](const ValueT& value, const CompValueT& comp_value) { return compare(value, comp_value); });
+    }
+
+    for (const auto& comp_value : comp_values)
+    {
+        begin_index = stream_lower_bound<CompValueT, ValueT>(in, start_position, begin_index, end_index, comp_value, compare);
+        *out++ = begin_index;
+    }
+
+    return out;
+}
+
+template<std::ranges::contiguous_range RangeT, std::output_iterator<std::size_t> OutputIt>
+    requires concepts::trivially_copyable<std::ranges::range_value_t<RangeT>>
+OutputIt stream_lower_bounds(istream_view in,
+                             istream_view::pos_type start_position,
+                             std::size_t begin_index,
+                             std::size_t end_index,
+                             const RangeT& comp_values,
+                             OutputIt out)
+{
+    using value_type = std::ranges::range_value_t<RangeT>;
+
+    return stream_lower_bounds<value_type, value_type>(in,
+                                                       start_position,
+                                                       begin_index,
+                                                       end_index,
+                                                       std::span<const value_type>(comp_values),
+                                                       out,
+                                                       std::less{});
+}
+
+// writes stream_upper_bound of every value in comp_values, which must be sorted,
+// choosing between a sequential pass and bisection like stream_lower_bounds
+template<typename CompValueT, concepts::trivially_copyable ValueT = CompValueT, std::output_iterator<std::size_t> OutputIt>
+OutputIt stream_upper_bounds(istream_view in,
+                             istream_view::pos_type start_position,
+                             std::size_t begin_index,
+                             std::size_t end_index,
+                             std::span<const CompValueT> comp_values,
+                             OutputIt out,
+                             concepts::right_comparator<CompValueT, ValueT> auto compare)
+{
+    if (begin_index < end_index
+        && detail::stream_prefer_merge(end_index - begin_index, comp_values.size(), sizeof(ValueT)))
+    {
+        return detail::stream_merge_bounds<CompValueT, ValueT>(
+            in,
+            start_position,
+            begin_index,
+            end_index,
+            comp_values,
+            out,
+            [&](const ValueT& value, const CompValueT& comp_value) { return !compare(comp_value, value); });
+    }
+
+    for (const auto& comp_value : comp_values)
+    {
+        begin_index = stream_upper_bound<CompValueT, ValueT>(in, start_position, begin_index, end_index, comp_value, compare);
+        *out++ = begin_index;
+    }
+
+    return out;
+}
+
+template<std::ranges::contiguous_range RangeT, std::output_iterator<std::size_t> OutputIt>
+    requires concepts::trivially_copyable<std::ranges::range_value_t<RangeT>>
+OutputIt stream_upper_bounds(istream_view in,
+                             istream_view::pos_type start_position,
+                             std::size_t begin_index,
+                             std::size_t end_index,
+                             const RangeT& comp_values,
+                             OutputIt out)
+{
+    using value_type = std::ranges::range_value_t<RangeT>;
+
+    return stream_upper_bounds<value_type, value_type>(in,
+                                                       start_position,
+                                                       begin_index,
+                                                       end_index,
+                                                       std::span<const value_type>(comp_values),
+                                                       out,
+                                                       std::less{});
+}
+
 } // namespace flow
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+
+namespace flow {
+
+// backend interfaces that istream_view and ostream_view can use instead of std streams
+// reads and writes that fit in the current buffer area are plain memcpy calls,
+// the virtual functions are only called to refill or drain it, or to seek outside of it
+
+class istream_backend
+{
+public:
+    using pos_type = std::istream::pos_type;
+    using off_type = std::istream::off_type;
+    using seekdir = std::istream::seekdir;
+    using iostate = std::istream::iostate;
+
+    static constexpr auto goodbit = std::istream::goodbit;
+    static constexpr auto badbit = std::istream::badbit;
+    static constexpr auto failbit = std::istream::failbit;
+    static constexpr auto eofbit = std::istream::eofbit;
+
+    static constexpr auto begin = std::istream::beg;
+    static constexpr auto end = std::istream::end;
+    static constexpr auto current = std::istream::cur;
+
+public:
+    istream_backend() noexcept = default;
+    istream_backend(const istream_backend& other) = delete;
+    istream_backend& operator=(const istream_backend& other) = delete;
+    virtual ~istream_backend() = default;
+
+    std::size_t read(std::span<std::byte> bytes)
+    {
+        if (m_state == goodbit && bytes.size() <= static_cast<std::size_t>(m_get_end - m_get_current))
+        {
+            if (!bytes.empty())
+            {
+                std::memcpy(bytes.data(), m_get_current, bytes.size());
+                m_get_current += bytes.size();
+            }
+
+            return bytes.size();
+        }
+
+        if (m_state != goodbit)
+        {
+            m_state |= failbit;
+            return 0;
+        }
+
+        const std::size_t count = do_read(bytes);
+
+        if (count < bytes.size())
+        {
+            m_state |= eofbit | failbit;
+        }
+
+        return count;
+    }
+
+    // returns a pointer to the next count values of size bytes that stays valid for the lifetime
+    // of the backend and advances past them, or nullptr and sets the failbit if the backend
+    // doesn't support it, there are not enough bytes left or they are not aligned
+    [[nodiscard]] const std::byte* view(std::size_t count, std::size_t size = 1, std::size_t alignment = 1)
+    {
+        if (m_state != goodbit)
+        {
+            m_state |= failbit;
+            return nullptr;
+        }
+
+        const std::byte* ptr = do_view(count, size, alignment);
+
+        if (!ptr)
+        {
+            m_state |= failbit;
+        }
+
+        return ptr;
+    }
+
+    void seek(pos_type position)
+    {
+        seek(static_cast<off_type>(position), begin);
+    }
+
+    void seek(off_type offset, seekdir direction)
+    {
+        m_state &= ~eofbit;
+
+        if (m_state != goodbit)
+        {
+            return;
+        }
+
+        if (!do_seekg(offset, direction))
+        {
+            m_state |= failbit;
+        }
+    }
+
+    [[nodiscard]] pos_type tell()
+    {
+        return fail() ? pos_type{ -1 } : do_tellg();
+    }
+
+    [[nodiscard]] iostate rdstate() const noexcept
+    {
+        return m_state;
+    }
+
+    [[nodiscard]] bool good() const noexcept
+    {
+        return m_state == goodbit;
+    }
+
+    [[nodiscard]] bool eof() const noexcept
+    {
+        return (m_state & eofbit) != 0;
+    }
+
+    [[nodiscard]] bool fail() const noexcept
+    {
+        return (m_state & (failbit | badbit)) != 0;
+    }
+
+    [[nodiscard]] bool bad() const noexcept
+    {
+        return (m_state & badbit) != 0;
+    }
+
+    void clear(iostate state = goodbit) noexcept
+    {
+        m_state = state;
+    }
+
+    void setstate(iostate state) noexcept
+    {
+        m_state |= state;
+    }
+
+protected:
+    void set_get_area(const std::byte* first, const std::byte* last) noexcept
+    {
+        m_get_current = first;
+        m_get_end = last;
+    }
+
+    [[nodiscard]] const std::byte* get_current() const noexcept
+    {
+        return m_get_current;
+    }
+
+    [[nodiscard]] const std::byte* get_end() const noexcept
+    {
+        return m_get_end;
+    }
+
+    // called when the get area holds less than the requested bytes,
+    // returns the number of bytes read, including those from the get area
+    virtual std::size_t do_read(std::span<std::byte> bytes) = 0;
+
+    virtual bool do_seekg(off_type offset, seekdir direction) = 0;
+
+    [[nodiscard]] virtual pos_type do_tellg() = 0;
+
+    // count is checked against the bytes left before it is multiplied by size, so a corrupt
+    // count can't wrap around to a small number of bytes
+    [[nodiscard]] virtual const std::byte* do_view(std::size_t /*count*/, std::size_t /*size*/, std::size_t /*alignment*/)
+    {
+        return nullptr;
+    }
+
+private:
+    const std::byte* m_get_current{ nullptr };
+    const std::byte* m_get_end{ nullptr };
+    iostate m_state{ goodbit };
+};
+
+class ostream_backend
+{
+public:
+    using pos_type = std::ostream::pos_type;
+    using off_type = std::ostream::off_type;
+    using seekdir = std::ostream::seekdir;
+    using iostate = std::ostream::iostate;
+
+    static constexpr auto goodbit = std::ostream::goodbit;
+    static constexpr auto badbit = std::ostream::badbit;
+    static constexpr auto failbit = std::ostream::failbit;
+    static constexpr auto eofbit = std::ostream::eofbit;
+
+    static constexpr auto begin = std::ostream::beg;
+    static constexpr auto end = std::ostream::end;
+    static constexpr auto current = std::ostream::cur;
+
+public:
+    ostream_backend() noexcept = default;
+    ostream_backend(const ostream_backend& other) = delete;
+    ostream_backend& operator=(const ostream_backend& other) = delete;
+    virtual ~ostream_backend() = default;
+
+    std::size_t write(std::span<const std::byte> bytes)
+    {
+        if (m_state == goodbit && bytes.size() <= static_cast<std::size_t>(m_put_end - m_put_current))
+        {
+            if (!bytes.empty())
+            {
+                std::memcpy(m_put_current, bytes.data(), bytes.size());
+                m_put_current += bytes.size();
+            }
+
+            return bytes.size();
+        }
+
+        if (m_state != goodbit)
+        {
+            m_state |= failbit;
+            return 0;
+        }
+
+        const std::size_t count = do_write(bytes);
+
+        if (count < bytes.size())
+        {
+            m_state |= badbit;
+        }
+
+        return count;
+    }
+
+    void flush()
+    {
+        if (m_state == goodbit && !do_flush())
+        {
+            m_state |= badbit;
+        }
+    }
+
+    void seek(pos_type position)
+    {
+        seek(static_cast<off_type>(position), begin);
+    }
+
+    void seek(off_type offset, seekdir direction)
+    {
+        if (m_state != goodbit)
+        {
+            return;
+        }
+
+        if (!do_seekp(offset, direction))
+        {
+            m_state |= failbit;
+        }
+    }
+
+    [[nodiscard]] pos_type tell()
+    {
+        return fail() ? pos_type{ -1 } : do_tellp();
+    }
+
+    [[nodiscard]] iostate rdstate() const noexcept
+    {
+        return m_state;
+    }
+
+    [[nodiscard]] bool good() const noexcept
+    {
+        return m_state == goodbit;
+    }
+
+    [[nodiscard]] bool eof() const noexcept
+    {
+        return (m_state & eofbit) != 0;
+    }
+
+    [[nodiscard]] bool fail() const noexcept
+    {
+        return (m_state & (failbit | badbit)) != 0;
+    }
+
+    [[nodiscard]] bool bad() const noexcept
+    {
+        return (m_state & badbit) != 0;
+    }
+
+    void clear(iostate state = goodbit) noexcept
+    {
+        m_state = state;
+    }
+
+    void setstate(iostate state) noexcept
+    {
+        m_state |= state;
+    }
+
+protected:
+    void set_put_area(std::byte* first, std::byte* last) noexcept
+    {
+        m_put_current = first;
+        m_put_end = last;
+    }
+
+    [[nodiscard]] std::byte* put_current() const noexcept
+    {
+        return m_put_current;
+    }
+
+    [[nodiscard]] std::byte* put_end() const noexcept
+    {
+        return m_put_end;
+    }
+
+    // called when the put area has less room than the written bytes,
+    // returns the number of bytes written, including those put in the put area
+    virtual std::size_t do_write(std::span<const std::byte> bytes) = 0;
+
+    virtual bool do_seekp(off_type offset, seekdir direction) = 0;
+
+    [[nodiscard]] virtual pos_type do_tellp() = 0;
+
+    virtual bool do_flush()
+    {
+        return true;
+    }
+
+private:
+    std::byte* m_put_current{ nullptr };
+    std::byte* m_put_end{ nullptr };
+    iostate m_state{ goodbit };
+};
+
+} // namespace flow
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "concepts.hpp"
+#include "istream_view.hpp"
+#include "ostream_view.hpp"
+#include "stream_algorithm.hpp"
+
+namespace flow {
+
+// static b+ tree over a sorted array of values stored in a stream, kept in a companion stream
+// the array is split into pages of page_size bytes, each index level holds the last value of
+// every page of the level below, and every level is split into pages the same way,
+// up to a top level that fits in a single page
+// a lookup reads one page per level that is not cached in memory, plus one page of the
+// array, instead of the ~log2(n) scattered reads of stream_lower_bound
+// a lookup whose reads fail returns std::nullopt and clears the state of the failed stream,
+// so the next lookup reads again
+template<concepts::trivially_copyable T>
+class stream_page_index
+{
+public:
+    using value_type = T;
+    using pos_type = istream_view::pos_type;
+    using off_type = istream_view::off_type;
+
+    static constexpr std::size_t default_page_size = 4096;
+    static constexpr std::size_t default_cache_size = std::size_t{ 1 } << 20;
+
+private:
+    static constexpr std::uint32_t magic = 0x58495046; // "FPIX"
+
+    struct header
+    {
+        std::uint32_t magic;
+        std::uint32_t value_size;
+        std::uint64_t element_count;
+        std::uint64_t page_element_count;
+        std::uint64_t level_count;
+    };
+
+    struct level
+    {
+        std::uint64_t size;
+        pos_type position;
+        std::vector<value_type> cache; // empty if the level is not cached
+    };
+
+public:
+    stream_page_index() noexcept = default;
+
+    // writes the index of the count sorted values at data_position to out
+    static bool write(istream_view data,
+                      pos_type data_position,
+                      std::size_t count,
+                      ostream_view out,
+                      std::size_t page_size = default_page_size)
+    {
+        const std::size_t page_element_count = std::max<std::size_t>(page_size / sizeof(value_type), 2);
+        const std::size_t page_bytes = page_element_count * sizeof(value_type);
+
+        std::vector<std::vector<value_type>> levels{};
+
+        // the bottom level holds the last value of every page of the array
+        auto& bottom = levels.emplace_back(page_count(count, page_element_count));
+
+        for (std::size_t page = 0; page < bottom.size(); ++page)
+        {
+            const std::size_t last = std::min((page + 1) * page_element_count, count) - 1;
+            data.seek(data_position + static_cast<off_type>(last * sizeof(value_type))).read(bottom[page]);
+        }
+
+        if (!data)
+        {
+            return false;
+        }
+
+        while (levels.back().size() > page_element_count)
+        {
+            const auto& below = levels.back();
+            std::vector<value_type> above(page_count(below.size(), page_element_count));
+
+            for (std::size_t page = 0; page < above.size(); ++page)
+            {
+                above[page] = below[std::min((page + 1) * page_element_count, below.size()) - 1];
+            }
+
+            levels.push_back(std::move(above));
+        }
+
+        const pos_type index_position = out.tell();
+
+        out.write(header{
+            .magic = magic,
+            .value_size = sizeof(value_type),
+            .element_count = count,
+            .page_element_count = page_element_count,
+            .level_count = count > 0 ? levels.size() : 0,
+        });
+
+        if (count == 0)
+        {
+            return static_cast<bool>(out);
+        }
+
+        // every level starts on a page boundary, relative to the start of the index
+        const std::vector<std::byte> padding(page_bytes);
+        std::size_t offset = sizeof(header);
+
+        for (const auto& values : levels)
+        {
+            const std::size_t aligned = round_up(offset, page_bytes);
+
+            out.write(std::span(padding).first(aligned - offset));
+            out.write(std::span<const value_type>(values));
+
+            offset = aligned + values.size() * sizeof(value_type);
+        }
+
+        return static_cast<bool>(out);
+    }
+
+    // reads the index at index_position and caches the top levels that fit in cache_size bytes,
+    // both views must stay valid while the index is used and may refer to the same stream
+    bool open(istream_view index,
+              pos_type index_position,
+              istream_view data,
+              pos_type data_position,
+              std::size_t cache_size = default_cache_size)
+    {
+        m_index = index;
+        m_data = data;
+        m_data_position = data_position;
+        m_levels.clear();
+        m_element_count = 0;
+
+        header h{};
+        index.seek(index_position).read(h);
+
+        if (!index || h.magic != magic || h.value_size != sizeof(value_type) || h.page_element_count < 2)
+        {
+            return false;
+        }
+
+        m_element_count = static_cast<std::size_t>(h.element_count);
+        m_page_element_count = static_cast<std::size_t>(h.page_element_count);
+
+        const std::size_t page_bytes = m_page_element_count * sizeof(value_type);
+        std::size_t offset = sizeof(header);
+        std::size_t size = m_element_count;
+
+        for (std::uint64_t i = 0; i < h.level_count; ++i)
+        {
+            size = page_count(size, m_page_element_count);
+            offset = round_up(offset, page_bytes);
+
+            m_levels.push_back({
+                .size = size,
+                .position = index_position + static_cast<off_type>(offset),
+                .cache = {},
+            });
+
+            offset += size * sizeof(value_type);
+        }
+
+        // the top level always fits in a single page and is always cached
+        std::size_t cached_size = 0;
+
+        for (auto it = m_levels.rbegin(); it != m_levels.rend(); ++it)
+        {
+            const std::size_t bytes = it->size * sizeof(value_type);
+
+            if (it != m_levels.rbegin() && cached_size + bytes > cache_size)
+            {
+                break;
+            }
+
+            it->cache.resize(it->size);
+            index.seek(it->position).read(std::span(it->cache));
+            cached_size += bytes;
+        }
+
+        m_page.resize(m_page_element_count);
+
+        return static_cast<bool>(index);
+    }
+
+    template<typename CompValueT>
+    [[nodiscard]] std::optional<std::size_t> lower_bound(const CompValueT& comp_value,
+                                          concepts::left_comparator<value_type, CompValueT> auto compare)
+    {
+        return search([&](const value_type& value) { return compare(value, comp_value); });
+    }
+
+    [[nodiscard]] std::optional<std::size_t> lower_bound(const value_type& comp_value)
+    {
+        return lower_bound(comp_value, std::less{});
+    }
+
+    template<typename CompValueT>
+    [[nodiscard]] std::optional<std::size_t> upper_bound(const CompValueT& comp_value,
+                                          concepts::right_comparator<CompValueT, value_type> auto compare)
+    {
+        return search([&](const value_type& value) { return !compare(comp_value, value); });
+    }
+
+    [[nodiscard]] std::optional<std::size_t> upper_bound(const value_type& comp_value)
+    {
+        return upper_bound(comp_value, std::less{});
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+        return m_element_count;
+    }
+
+    [[nodiscard]] constexpr std::size_t page_element_count() const noexcept
+    {
+        return m_page_element_count;
+    }
+
+    [[nodiscard]] constexpr std::size_t level_count() const noexcept
+    {
+        return m_levels.size();
+    }
+
+private:
+    [[nodiscard]] static constexpr std::size_t page_count(std::size_t count, std::size_t page_element_count) noexcept
+    {
+        return (count + page_element_count - 1) / page_element_count;
+    }
+
+    [[nodiscard]] static constexpr std::size_t round_up(std::size_t offset, std::size_t alignment) noexcept
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    // returns the index of the first value for which is_before returns false, or std::nullopt
+    // if a read failed, the values must be partitioned by is_before
+    template<typename PredicateT>
+    [[nodiscard]] std::optional<std::size_t> search(PredicateT is_before)
+    {
+        if (m_levels.empty())
+        {
+            return m_element_count;
+        }
+
+        // index of the page in the level below, starting with the single page of the top level
+        std::size_t page = 0;
+
+        for (auto it = m_levels.rbegin(); it != m_levels.rend(); ++it)
+        {
+            const std::optional<std::span<const value_type>> values = level_page(*it, page);
+
+            if (!values)
+            {
+                return std::nullopt;
+            }
+
+            const std::size_t i = partition_point(*values, is_before);
+
+            if (i == values->size())
+            {
+                return m_element_count;
+            }
+
+            page = page * m_page_element_count + i;
+        }
+
+        const std::size_t first = page * m_page_element_count;
+        const std::size_t count = std::min(m_page_element_count, m_element_count - first);
+
+        m_data.seek(m_data_position + static_cast<off_type>(first * sizeof(value_type)))
+            .read(std::span(m_page).first(count));
+
+        if (!m_data)
+        {
+            m_data.clear();
+            return std::nullopt;
+        }
+
+        return first + partition_point(std::span<const value_type>(m_page).first(count), is_before);
+    }
+
+    // returns std::nullopt if the page of a level that is not cached couldn't be read
+    [[nodiscard]] std::optional<std::span<const value_type>> level_page(const level& l, std::size_t page)
+    {
+        const std::size_t first = page * m_page_element_count;
+        const std::size_t count = std::min<std::size_t>(m_page_element_count, l.size - first);
+
+        if (!l.cache.empty())
+        {
+            return std::span(l.cache).subspan(first, count);
+        }
+
+        m_index.seek(l.position + static_cast<off_type>(first * sizeof(value_type)))
+            .read(std::span(m_page).first(count));
+
+        if (!m_index)
+        {
+            m_index.clear();
+            return std::nullopt;
+        }
+
+        return std::span<const value_type>(m_page).first(count);
+    }
+
+    template<typename PredicateT>
+    [[nodiscard]] static std::size_t partition_point(std::span<const value_type> values, PredicateT& is_before)
+    {
+        return static_cast<std::size_t>(std::ranges::partition_point(values, is_before) - values.begin());
+    }
+
+private:
+    istream_view m_index{};
+    istream_view m_data{};
+    pos_type m_data_position{};
+    std::vector<level> m_levels{}; // from the bottom to the top
+    std::vector<value_type> m_page{};
+    std::size_t m_element_count{};
+    std::size_t m_page_element_count{};
+};
+
+} // namespace flow
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "concepts.hpp"
+#include "istream_view.hpp"
+#include "ostream_view.hpp"
+#include "serialization.hpp"
+
+namespace flow {
+
+// read-only view over a serialized std::vector, that shares its binary layout,
+// so it can be deserialized in place from a memory backed istream_view
+// (e.g. a mapped_file) without allocating or copying the values
+// when the values can't be viewed in place (the stream is not memory backed, they are not
+// aligned or need byte swapping) they are copied into storage shared by the copies of the view
+template<concepts::trivially_copyable T>
+class vector_view
+{
+public:
+    using value_type = T;
+    using size_type = typename std::vector<T>::size_type;
+    using span_type = std::span<const value_type>;
+    using iterator = typename span_type::iterator;
+
+public:
+    constexpr vector_view() noexcept = default;
+
+    constexpr vector_view(span_type values) noexcept
+        : m_values{ values }
+    {}
+
+    explicit vector_view(std::vector<value_type> values)
+        : m_storage{ std::make_shared<const std::vector<value_type>>(std::move(values)) }
+        , m_values{ *m_storage }
+    {}
+
+    [[nodiscard]] constexpr iterator begin() const noexcept
+    {
+        return m_values.begin();
+    }
+
+    [[nodiscard]] constexpr iterator end() const noexcept
+    {
+        return m_values.end();
+    }
+
+    [[nodiscard]] constexpr const value_type* data() const noexcept
+    {
+        return m_values.data();
+    }
+
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return m_values.size();
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return m_values.empty();
+    }
+
+    [[nodiscard]] constexpr const value_type& operator[](size_type index) const noexcept
+    {
+        return m_values[index];
+    }
+
+    [[nodiscard]] constexpr span_type values() const noexcept
+    {
+        return m_values;
+    }
+
+    [[nodiscard]] std::vector<value_type> to_vector() const
+    {
+        return { m_values.begin(), m_values.end() };
+    }
+
+    // whether the values were copied instead of viewed in place
+    [[nodiscard]] bool owns_values() const noexcept
+    {
+        return m_storage != nullptr;
+    }
+
+private:
+    std::shared_ptr<const std::vector<value_type>> m_storage{};
+    span_type m_values{};
+};
+
+template<typename T>
+struct deserializer<vector_view<T>>
+{
+    void operator()(istream_view in, vector_view<T>& v) const
+    {
+        using size_type = typename vector_view<T>::size_type;
+
+        size_type size;
+        if (!in.read(size))
+        {
+            return;
+        }
+
+        typename vector_view<T>::span_type values{};
+
+        if (in.view(values, size))
+        {
+            v = vector_view<T>(values);
+            return;
+        }
+
+        // the values run past the end of the memory, a copy would only fail after allocating them
+        if (in.eof())
+        {
+            v = vector_view<T>{};
+            return;
+        }
+
+        // a failed view doesn't move the stream, which was good before it
+        in.clear();
+
+        std::vector<T> copy(size);
+        if (in.read(std::span(copy)))
+        {
+            v = vector_view<T>(std::move(copy));
+        }
+        else
+        {
+            v = vector_view<T>{};
+        }
+    }
+};
+
+template<typename T>
+struct serializer<vector_view<T>>
+{
+    void operator()(ostream_view out, const vector_view<T>& v) const
+    {
+        if (!out.write(v.size()))
+        {
+            return;
+        }
+
+        out.write(v.values());
+    }
+};
+
+} // namespace flow
@@ -2,8 +2,16 @@
 
 #include <memory>
 
+// #include "tests/allocator_test.hpp"
 // #include "tests/line_renderer_test.hpp"
+// #include "tests/noise_benchmark_test.hpp"
+// #include "tests/noise_test.hpp"
+// #include "tests/noise_texture_test.hpp"
+// #include "tests/poisson_disk_test.hpp"
+// #include "tests/random_test.hpp"
 // #include "tests/rectangle_renderer_test.hpp"
+// #include "tests/serialization_test.hpp"
+// #include "tests/stream_test.hpp"
 #include "tests/physics_test.hpp"
 
 namespace flow {
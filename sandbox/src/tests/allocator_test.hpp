@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/graphics/opengl/buffer_heap.hpp>
+#include <flow/utility/buddy_partitioner.hpp>
+#include <flow/utility/concurrent_buddy_partitioner.hpp>
+
+#include "expect.hpp"
+
+// allocations that are freed back to a single free block, and the ones that must fail,
+// every failed check is logged as an error
+class allocator_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        test_concurrent_buddy_partitioner();
+        test_buffer_heap();
+        test_buddy_partitioner_statistics();
+        test_buddy_partitioner_batches();
+
+        engine.quit();
+    }
+
+private:
+    using allocation = std::pair<std::uint32_t, std::uint32_t>; // offset and size
+    using partitioner_type = flow::buddy_partitioner<std::uint32_t, std::uint32_t>;
+
+    // small sizes go through the caches of the shards, large ones to the shared partitioner,
+    // every thread marks the bytes it owns, so overlapping allocations are found
+    static void test_concurrent_buddy_partitioner()
+    {
+        constexpr std::uint32_t block_count = 1 << 12;
+        constexpr std::uint32_t block_size = 16;
+        constexpr std::size_t thread_count = 4;
+        constexpr std::size_t iteration_count = 20000;
+
+        flow::concurrent_buddy_partitioner<std::uint32_t, std::uint32_t> partitioner(block_count, block_size);
+        const std::uint32_t capacity = partitioner.capacity();
+
+        std::vector<std::uint8_t> owners(capacity, 0);
+        std::atomic<std::size_t> overlap_count{ 0 };
+        std::atomic<std::size_t> alloc_count{ 0 };
+
+        {
+            std::vector<std::jthread> threads{};
+
+            for (std::size_t t = 0; t < thread_count; ++t)
+            {
+                threads.emplace_back([&, owner = static_cast<std::uint8_t>(t + 1)] {
+                    std::vector<allocation> live{};
+                    std::uint32_t state = owner;
+
+                    const auto release = [&](const allocation& a) {
+                        std::fill_n(owners.begin() + a.first, a.second, std::uint8_t{ 0 });
+                        partitioner.free(a.first);
+                    };
+
+                    for (std::size_t i = 0; i < iteration_count; ++i)
+                    {
+                        state = state * 1664525U + 1013904223U;
+
+                        if ((state >> 16U) % 2 == 0 && !live.empty())
+                        {
+                            const std::size_t slot = (state >> 8U) % live.size();
+                            release(live[slot]);
+                            live[slot] = live.back();
+                            live.pop_back();
+                            continue;
+                        }
+
+                        const std::uint32_t size = 1 + (state >> 20U) % ((state & 7U) == 0 ? 1000U : 60U);
+                        const std::optional<std::uint32_t> offset = partitioner.alloc(size);
+
+                        if (!offset)
+                        {
+                            continue;
+                        }
+
+                        for (std::uint32_t k = 0; k < size; ++k)
+                        {
+                            overlap_count += owners[*offset + k] != 0 ? 1 : 0;
+                            owners[*offset + k] = owner;
+                        }
+
+                        live.emplace_back(*offset, size);
+                        ++alloc_count;
+                    }
+
+                    for (const allocation& a : live)
+                    {
+                        release(a);
+                    }
+                });
+            }
+        }
+
+        expect(overlap_count == 0, "concurrent allocations without overlaps");
+
+        // the caches hold on to blocks until they are trimmed
+        partitioner.trim();
+        const auto stats = partitioner.stats();
+        expect(stats.allocation_count == 0 && stats.largest_free_size == capacity, "freeing every concurrent allocation");
+
+        expect(!partitioner.alloc(capacity + 1), "allocating more than the capacity");
+
+        const std::optional<std::uint32_t> whole = partitioner.alloc(capacity);
+        expect(whole && *whole == 0 && !partitioner.alloc(1), "allocating the whole capacity");
+
+        FLOW_LOG_INFO("concurrent buddy partitioner: {} allocations on {} threads", alloc_count.load(), thread_count);
+    }
+
+    // freed allocations are only reused after they are retired and their fence is signaled,
+    // a failed create keeps the heap, the heap is used from start, after the context was created
+    static void test_buffer_heap()
+    {
+        constexpr std::size_t capacity = 1 << 16;
+        constexpr std::size_t count = 100;
+
+        flow::gl::buffer_heap heap{};
+        expect(heap.create(capacity) && heap.capacity() == capacity, "creating a buffer heap");
+
+        const auto floats = heap.alloc<float>(count);
+        const auto indices = heap.alloc<std::uint32_t>(count * 4);
+        expect(floats && indices && floats.values.size() == count && indices.values.size() == count * 4,
+               "allocating from a buffer heap");
+
+        expect(floats.offset % heap.block_size() == 0 && indices.offset % heap.block_size() == 0
+                   && (floats.offset + floats.values.size_bytes() <= indices.offset
+                       || indices.offset + indices.values.size_bytes() <= floats.offset),
+               "aligned allocations without overlaps");
+
+        // the mapping is persistent and coherent, so the values are written in place
+        std::ranges::fill(floats.values, 1.0F);
+        std::ranges::fill(indices.values, 7U);
+
+        heap.bind_range(flow::gl::buffer_target::shader_storage, 0, indices);
+
+        expect(!heap.alloc<std::byte>(capacity + 1), "allocating more than the capacity");
+
+        // the freed allocations aren't reused until they are retired and reclaimed
+        heap.free(floats);
+        heap.free(indices);
+        expect(!heap.alloc<std::byte>(capacity), "reusing allocations that weren't retired");
+
+        heap.retire();
+        heap.reclaim_all();
+
+        const auto whole = heap.alloc<std::byte>(capacity);
+        expect(whole && whole.offset == 0, "reusing reclaimed allocations");
+
+        // a failed create keeps the heap, a second one drops its allocations
+        expect(!heap.create(heap.block_size() - 1) && heap.capacity() == capacity && !heap.alloc<std::byte>(1),
+               "failing to create a buffer heap again");
+
+        heap.free(whole);
+        heap.retire();
+
+        expect(heap.create(capacity) && heap.alloc<std::byte>(capacity), "creating a buffer heap again");
+
+        FLOW_LOG_INFO("buffer heap: {} bytes in blocks of {}", heap.capacity(), heap.block_size());
+    }
+
+    // the totals after a few allocations, after restoring the partitioner from its blocks
+    // and free lists, and after freeing everything again
+    static void test_buddy_partitioner_statistics()
+    {
+        constexpr std::uint32_t block_count = 16;
+        constexpr std::uint32_t block_size = 64;
+
+        partitioner_type partitioner(block_count, block_size);
+        const std::uint32_t capacity = partitioner.capacity();
+
+        const std::optional<std::uint32_t> first = partitioner.alloc(100);
+        const std::optional<std::uint32_t> second = partitioner.alloc(64);
+        expect(first && second && partitioner.block_level(*first) == 1 && partitioner.block_level(*second) == 0,
+               "allocating blocks");
+
+        expect(!partitioner.alloc(capacity), "allocating more than is free");
+
+        const auto stats = partitioner.stats();
+        expect(stats.requested_size == 164 && stats.allocated_size == 192 && stats.allocation_count == 2
+                   && stats.free_size == capacity - 192 && stats.largest_free_size == capacity / 2,
+               "the totals of the live allocations");
+        expect(stats.operations.allocs == 2 && stats.operations.failed_allocs == 1 && stats.operations.splits == 4,
+               "the counted operations");
+        expect(stats.internal_fragmentation() == 1.0 - 164.0 / 192.0
+                   && stats.external_fragmentation() == 1.0 - static_cast<double>(capacity / 2) / (capacity - 192),
+               "the fragmentation");
+
+        // the restored allocations are accounted as if they requested their whole blocks
+        std::vector<std::uint32_t> blocks(partitioner.blocks().begin(), partitioner.blocks().end());
+        std::vector<std::vector<std::uint32_t>> freelists(partitioner.freelists().begin(), partitioner.freelists().end());
+        std::vector<std::span<std::uint32_t>> freelist_spans(freelists.begin(), freelists.end());
+
+        partitioner_type restored{};
+        expect(restored.create(blocks, freelist_spans, block_size) == block_count, "restoring a partitioner");
+        expect(restored.allocation_count() == 2 && restored.allocated_size() == 192 && restored.requested_size() == 192
+                   && restored.free_size() == capacity - 192,
+               "the totals of a restored partitioner");
+
+        for (partitioner_type* p : { &partitioner, &restored })
+        {
+            p->free(*first);
+            p->free(*second);
+
+            expect(p->allocation_count() == 0 && p->requested_size() == 0 && p->allocated_size() == 0
+                       && p->largest_free_size() == capacity,
+                   "freeing every allocation");
+        }
+
+        expect(partitioner.operations().frees == 2 && partitioner.operations().merges == partitioner.operations().splits,
+               "merging every split block");
+
+        FLOW_LOG_INFO("buddy partitioner statistics: {} bytes in blocks of {}", capacity, block_size);
+    }
+
+    // a batch of one size, then a batch larger than what is free, all freed back in one go
+    static void test_buddy_partitioner_batches()
+    {
+        constexpr std::uint32_t block_count = 64;
+        constexpr std::uint32_t block_size = 16;
+        constexpr std::uint32_t size = 20;
+        constexpr std::uint32_t count = 10;
+
+        partitioner_type partitioner(block_count, block_size);
+        const std::uint32_t capacity = partitioner.capacity();
+
+        std::vector<std::uint32_t> offsets{};
+        expect(partitioner.alloc_n(size, count, std::back_inserter(offsets)) == count && offsets.size() == count,
+               "allocating a batch");
+
+        std::vector<std::uint32_t> sorted = offsets;
+        std::ranges::sort(sorted);
+
+        bool aligned = true;
+
+        for (std::size_t i = 0; i < sorted.size(); ++i)
+        {
+            aligned = aligned && sorted[i] % (block_size * 2) == 0 && (i == 0 || sorted[i - 1] + size <= sorted[i]);
+        }
+
+        expect(aligned && partitioner.allocation_count() == count && partitioner.requested_size() == size * count,
+               "a batch of aligned allocations without overlaps");
+
+        // the rest of the partitioner runs out before the batch is complete
+        const std::uint32_t available = partitioner.max_allocations(block_size);
+        const std::size_t batch_begin = offsets.size();
+        expect(partitioner.alloc_n(block_size, capacity, std::back_inserter(offsets)) == available
+                   && offsets.size() - batch_begin == available && partitioner.free_size() == 0,
+               "allocating a batch larger than what is free");
+
+        expect(!partitioner.alloc(1) && partitioner.alloc_n(1, 1, std::back_inserter(offsets)) == 0,
+               "allocating from a full partitioner");
+
+        partitioner.free_n(offsets);
+        expect(partitioner.allocation_count() == 0 && partitioner.largest_free_size() == capacity
+                   && partitioner.operations().merges == partitioner.operations().splits,
+               "freeing a batch");
+
+        FLOW_LOG_INFO("buddy partitioner batches: {} and {} allocations", count, available);
+    }
+};
@@ -1,12 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <limits>
+#include <span>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <flow/core/application.hpp>
 #include <flow/core/logger.hpp>
 #include <flow/utility/dense_tree.hpp>
 #include <flow/utility/iostream_view.hpp>
+#include <flow/utility/mapped_file.hpp>
+#include <flow/utility/memory_istream.hpp>
+#include <flow/utility/vector_view.hpp>
 
 class dense_tree_test final : public flow::application
 {
@@ -46,5 +60,163 @@ public:
             ss << node << " ";
         }
         FLOW_LOG_INFO("tree2: {}", ss.view());
+
+        // the node slots of these trees are aligned in the serialized form only for some of them
+        test_view<flow::dense_tree<std::uint32_t, std::uint32_t>>("uint32_t nodes, uint32_t indices");
+        test_view<flow::dense_tree<double, std::uint32_t>>("double nodes, uint32_t indices");
+        test_view<flow::dense_tree<float, std::uint16_t>>("float nodes, uint16_t indices");
+        test_view<flow::dense_tree<double, std::uint64_t>>("double nodes, uint64_t indices");
+        test_empty_mapped_file();
+    }
+
+private:
+    // views a serialized tree from aligned memory, and from memory one byte off, which must
+    // fall back to copying, then after seeking past values in front of it, and from a truncated
+    // copy and a copy with a forged count, which must fail
+    template<typename TreeT>
+    static void test_view(std::string_view name)
+    {
+        using value_type = typename TreeT::value_type;
+
+        TreeT tree{};
+
+        // NOLINTBEGIN(*-avoid-magic-numbers)
+        auto root = tree.insert_after(tree.before_begin(), value_type{ 1 });
+        tree.insert_after(root, value_type{ 2 });
+        tree.insert_after(root, value_type{ 3 });
+        // NOLINTEND(*-avoid-magic-numbers)
+
+        std::stringstream ss{};
+        flow::ostream_view(ss).serialize(tree);
+        const std::string bytes = ss.str();
+
+        for (std::size_t offset : { std::size_t{ 0 }, std::size_t{ 1 } })
+        {
+            std::vector<std::max_align_t> storage(bytes.size() / sizeof(std::max_align_t) + 2);
+            auto* data = reinterpret_cast<std::byte*>(storage.data()) + offset; // NOLINT(*-reinterpret-cast)
+            std::memcpy(data, bytes.data(), bytes.size());
+
+            flow::memory_istream memory(std::span<const std::byte>(data, bytes.size()));
+            flow::istream_view in(memory);
+
+            flow::dense_tree_view<TreeT> view{};
+            in.deserialize(view);
+
+            if (!in || !equal(view.to_tree(), tree))
+            {
+                FLOW_LOG_ERROR("{}: viewing at offset {} failed", name, offset);
+                continue;
+            }
+
+            const auto* nodes = reinterpret_cast<const std::byte*>(view.node_slots().data()); // NOLINT(*-reinterpret-cast)
+            const bool in_place = std::less_equal<>{}(data, nodes) && std::less<>{}(nodes, data + bytes.size());
+
+            FLOW_LOG_INFO("{}: offset {}, node slots {}", name, offset, in_place ? "viewed in place" : "copied");
+        }
+
+        test_view_after_seek(tree, name);
+        test_forged_count<TreeT>(bytes, name);
+
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+        flow::istream_view in(truncated);
+        flow::dense_tree_view<TreeT> view{};
+
+        if (in.deserialize(view))
+        {
+            FLOW_LOG_ERROR("{}: a truncated tree was loaded", name);
+        }
+    }
+
+    // the tree follows a few values, it is viewed after seeking to it, then the values after
+    // seeking back to them
+    template<typename TreeT>
+    static void test_view_after_seek(const TreeT& tree, std::string_view name)
+    {
+        using value_type = typename TreeT::value_type;
+
+        // NOLINTNEXTLINE(*-avoid-magic-numbers)
+        const std::vector<value_type> values{ value_type{ 5 }, value_type{ 7 }, value_type{ 9 } };
+
+        std::stringstream ss{};
+        flow::ostream_view out(ss);
+        out.serialize(flow::vector_view<value_type>(values));
+        const auto tree_position = out.tell();
+        out.serialize(tree);
+        const std::string bytes = ss.str();
+
+        std::vector<std::max_align_t> storage(bytes.size() / sizeof(std::max_align_t) + 1);
+        auto* data = reinterpret_cast<std::byte*>(storage.data()); // NOLINT(*-reinterpret-cast)
+        std::memcpy(data, bytes.data(), bytes.size());
+
+        flow::memory_istream memory(std::span<const std::byte>(data, bytes.size()));
+        flow::istream_view in(memory);
+
+        flow::dense_tree_view<TreeT> view{};
+        in.seek(static_cast<flow::istream_view::pos_type>(tree_position)).deserialize(view);
+
+        flow::vector_view<value_type> read_values{};
+        in.seek(0).deserialize(read_values);
+
+        if (!in || !equal(view.to_tree(), tree) || !std::ranges::equal(read_values, values))
+        {
+            FLOW_LOG_ERROR("{}: viewing after a seek failed", name);
+        }
+    }
+
+    // a count of node slots that wraps around when multiplied by their size must not be viewed
+    template<typename TreeT>
+    static void test_forged_count(const std::string& bytes, std::string_view name)
+    {
+        using node_type = typename TreeT::node_type;
+        using size_type = typename flow::vector_view<node_type>::size_type;
+
+        // the node slots are counted after the root index
+        constexpr std::size_t count_position = sizeof(typename TreeT::index_type);
+        constexpr size_type forged_count = std::numeric_limits<size_type>::max() / sizeof(node_type) + 1;
+
+        std::vector<std::max_align_t> storage(bytes.size() / sizeof(std::max_align_t) + 1);
+        auto* data = reinterpret_cast<std::byte*>(storage.data()); // NOLINT(*-reinterpret-cast)
+        std::memcpy(data, bytes.data(), bytes.size());
+        std::memcpy(data + count_position, &forged_count, sizeof(forged_count));
+
+        flow::memory_istream memory(std::span<const std::byte>(data, bytes.size()));
+        flow::istream_view in(memory);
+
+        flow::dense_tree_view<TreeT> view{};
+        in.deserialize(view);
+
+        if (in || !view.node_slots().empty())
+        {
+            FLOW_LOG_ERROR("{}: a forged count of {} node slots was viewed", name, forged_count);
+        }
+    }
+
+    // an empty file is mapped as no bytes, a tree can't be viewed from it
+    static void test_empty_mapped_file()
+    {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "flow_dense_tree_test.bin";
+        std::ofstream{ path, std::ios::binary | std::ios::trunc }.close();
+
+        {
+            const flow::mapped_file file(path);
+            flow::memory_istream memory(file.bytes());
+            flow::istream_view in(memory);
+
+            flow::dense_tree_view<flow::dense_tree<std::uint32_t, std::uint32_t>> view{};
+            in.deserialize(view);
+
+            if (!file.is_open() || file.size() != 0 || in)
+            {
+                FLOW_LOG_ERROR("mapping an empty file failed");
+            }
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    template<typename TreeT>
+    static bool equal(const TreeT& lhs, const TreeT& rhs)
+    {
+        return std::vector(lhs.begin(), lhs.end()) == std::vector(rhs.begin(), rhs.end());
     }
 };
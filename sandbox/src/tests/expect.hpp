@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+
+#include <flow/core/logger.hpp>
+
+// the check of the sandbox tests, every failed check is logged as an error
+inline void expect(bool condition, std::string_view what)
+{
+    if (!condition)
+    {
+        FLOW_LOG_ERROR("{} failed", what);
+    }
+}
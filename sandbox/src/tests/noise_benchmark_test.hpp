@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/utility/noise.hpp>
+#include <flow/utility/time.hpp>
+
+// times the double, float and fixed point 2d noise generators on the same grid,
+// and how far the float and fixed point results are from the double ones, near the origin
+// and far from it, then checks the fixed point noise against values it must give everywhere
+class noise_benchmark_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        constexpr std::uint64_t seed = 42;
+
+        const flow::noise_generator<2> double_noise(seed);
+        const flow::float_noise_generator<2> float_noise(seed);
+        const flow::fixed_noise_generator fixed_noise(seed);
+
+        std::vector<double> double_values(width * height);
+        std::vector<float> float_values(width * height);
+        std::vector<flow::fixed16_16_t> fixed_values(width * height);
+
+        const double scalar_time = measure([&] {
+            for (std::size_t y = 0; y < height; ++y)
+            {
+                for (std::size_t x = 0; x < width; ++x)
+                {
+                    double_values[y * width + x] = double_noise(static_cast<double>(x) * step, static_cast<double>(y) * step);
+                }
+            }
+        });
+
+        const double double_time = measure([&] {
+            double_noise.generator().fill(std::span(double_values), { 0.0, 0.0 }, { step, step }, width, height);
+        });
+
+        const double float_time = measure([&] {
+            float_noise.generator().fill(std::span(float_values),
+                                         { 0.0F, 0.0F },
+                                         { static_cast<float>(step), static_cast<float>(step) },
+                                         width,
+                                         height);
+        });
+
+        const double fixed_time = measure([&] {
+            fixed_noise.generator().fill(std::span(fixed_values),
+                                         { flow::fixed16_16_t(0), flow::fixed16_16_t(0) },
+                                         { flow::fixed16_16_t(step), flow::fixed16_16_t(step) },
+                                         width,
+                                         height);
+        });
+
+        double float_error = 0.0;
+        double fixed_error = 0.0;
+
+        for (std::size_t i = 0; i < double_values.size(); ++i)
+        {
+            float_error = std::max(float_error, std::abs(static_cast<double>(float_values[i]) - double_values[i]));
+            fixed_error = std::max(fixed_error, std::abs(static_cast<double>(fixed_values[i]) - double_values[i]));
+        }
+
+        FLOW_LOG_INFO("{}x{} points, best of {} runs", width, height, run_count);
+        FLOW_LOG_INFO("double point by point: {:.2f} ms", scalar_time);
+        FLOW_LOG_INFO("double fill: {:.2f} ms", double_time);
+        FLOW_LOG_INFO("float fill: {:.2f} ms, max error {:.2e}", float_time, float_error);
+        FLOW_LOG_INFO("fixed16_16 fill: {:.2f} ms, max error {:.2e}", fixed_time, fixed_error);
+
+        double far_error = 0.0;
+
+        for (std::size_t i = 0; i < far_point_count; ++i)
+        {
+            const auto x = flow::fixed16_16_t(far_origin + static_cast<double>(i) * far_step);
+            const auto y = flow::fixed16_16_t(-far_origin + static_cast<double>(i) * far_step * 0.5);
+            const double expected = double_noise(static_cast<double>(x), static_cast<double>(y));
+
+            far_error = std::max(far_error, std::abs(static_cast<double>(fixed_noise(x, y)) - expected));
+        }
+
+        FLOW_LOG_INFO("fixed16_16 around ({}, {}): max error {:.2e}", far_origin, -far_origin, far_error);
+
+        for (const auto& [x, y, raw] : fixed_golden_values)
+        {
+            const std::int32_t value = fixed_noise(flow::fixed16_16_t(x), flow::fixed16_16_t(y)).raw();
+
+            if (value != raw)
+            {
+                FLOW_LOG_ERROR("fixed16_16 noise at ({}, {}) is {} instead of {}", x, y, value, raw);
+            }
+        }
+
+        engine.quit();
+    }
+
+private:
+    static constexpr std::size_t width = 1024;
+    static constexpr std::size_t height = 1024;
+    static constexpr std::size_t run_count = 5;
+    static constexpr double step = 1.0 / 64.0;
+
+    static constexpr std::size_t far_point_count = 100000;
+    static constexpr double far_origin = 20000.0;
+    static constexpr double far_step = 1.0 / 16.0;
+
+    struct golden_value
+    {
+        double x;
+        double y;
+        std::int32_t raw;
+    };
+
+    // the raw values of the seed 42 noise, the coordinates are exact in 16.16
+    static constexpr std::array fixed_golden_values{
+        golden_value{ 0.5, 0.5, 24721 },
+        golden_value{ -3.25, 7.75, 52190 },
+        golden_value{ 123.4375, -78.875, -41239 },
+        golden_value{ 20000.125, -15000.5, -48441 },
+        golden_value{ -32000.0, 31000.75, 58563 },
+    };
+
+    // the fastest of run_count runs, in milliseconds
+    template<typename F>
+    static double measure(F&& function)
+    {
+        double best = 0.0;
+
+        for (std::size_t i = 0; i < run_count; ++i)
+        {
+            const auto start = flow::clock::now();
+            function();
+            const double time = flow::as_milliseconds<double>(flow::clock::now() - start);
+
+            best = i == 0 ? time : std::min(best, time);
+        }
+
+        return best;
+    }
+};
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/utility/fixed_point.hpp>
+#include <flow/utility/fractal_noise.hpp>
+#include <flow/utility/noise.hpp>
+#include <flow/utility/noise_field_cache.hpp>
+
+#include "expect.hpp"
+
+// the batched and tiled paths of the noise generators against their point by point values,
+// which they equal up to rounding, every failed check is logged as an error
+class noise_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        test_evaluate<flow::noise_generator<2>>("double");
+        test_evaluate<flow::float_noise_generator<2>>("float");
+        test_evaluate<flow::fixed_noise_generator>("fixed16_16");
+        test_fractal();
+        test_higher_dimensions<3>();
+        test_higher_dimensions<4>();
+        test_noise_field_cache();
+
+        engine.quit();
+    }
+
+private:
+    static constexpr std::uint64_t seed = 42;
+
+    // not a multiple of any simd width, so the batches end with a remainder
+    static constexpr std::size_t point_count = 1003;
+    static constexpr std::size_t width = 37;
+    static constexpr std::size_t height = 23;
+
+    // the batches and the point by point values may round differently, the fixed point ones don't
+    template<typename T>
+    static constexpr double tolerance = std::same_as<T, double> ? 1e-12 : std::same_as<T, float> ? 1e-5 : 0.0;
+
+    template<typename T>
+    static bool near(T lhs, T rhs)
+    {
+        return std::abs(static_cast<double>(lhs) - static_cast<double>(rhs)) <= tolerance<T>;
+    }
+
+    // scattered points on both sides of the origin, exact in 16.16 fixed point
+    template<typename T>
+    static std::vector<T> make_coordinates(std::size_t count, double scale, double offset)
+    {
+        std::vector<T> coordinates(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            coordinates[i] = T(static_cast<double>((i * 7919) % 4099) * scale + offset);
+        }
+
+        return coordinates;
+    }
+
+    // evaluate and fill must match operator() up to rounding
+    template<typename GeneratorT>
+    static void test_evaluate(std::string_view name)
+    {
+        using value_type = typename GeneratorT::value_type;
+
+        const GeneratorT noise(seed);
+
+        const std::vector<value_type> xs = make_coordinates<value_type>(point_count, 0.015625, -20.0);
+        const std::vector<value_type> ys = make_coordinates<value_type>(point_count, 0.0078125, -9.5);
+
+        std::vector<value_type> values(point_count);
+        noise.evaluate(std::span(xs), std::span(ys), std::span(values));
+
+        bool evaluated = true;
+
+        for (std::size_t i = 0; i < point_count; ++i)
+        {
+            evaluated = evaluated && near(values[i], noise(xs[i], ys[i]));
+        }
+
+        if (!evaluated)
+        {
+            FLOW_LOG_ERROR("{} noise: evaluate doesn't match operator()", name);
+        }
+
+        const value_type origin_x(-3.25);
+        const value_type origin_y(1.5);
+        const value_type step(0.125);
+
+        std::vector<value_type> grid(width * height);
+        noise.generator().fill(std::span(grid), { origin_x, origin_y }, { step, step }, width, height);
+
+        bool filled = true;
+
+        for (std::size_t y = 0; y < height; ++y)
+        {
+            for (std::size_t x = 0; x < width; ++x)
+            {
+                const value_type px = origin_x + value_type(static_cast<double>(x) * 0.125);
+                const value_type py = origin_y + value_type(static_cast<double>(y) * 0.125);
+
+                filled = filled && near(grid[y * width + x], noise(px, py));
+            }
+        }
+
+        if (!filled)
+        {
+            FLOW_LOG_ERROR("{} noise: fill doesn't match operator()", name);
+        }
+
+        FLOW_LOG_INFO("{} noise: {} points and a {}x{} grid", name, point_count, width, height);
+    }
+
+    // a single octave is the noise itself, the batches, the fills and the parallel fills give
+    // the values of single points, and the sums stay in their ranges
+    static void test_fractal()
+    {
+        constexpr std::size_t thread_count = 3;
+
+        using fractal_type = flow::fractal_noise_generator<2>;
+        using parameters_type = fractal_type::parameters_type;
+
+        const std::vector<double> xs = make_coordinates<double>(point_count, 0.015625, -20.0);
+        const std::vector<double> ys = make_coordinates<double>(point_count, 0.0078125, -9.5);
+
+        const flow::noise_generator<2> noise(seed);
+        const fractal_type octave(seed, parameters_type{ .octave_count = 1, .frequency = 0.5 });
+
+        bool single = true;
+
+        for (std::size_t i = 0; i < point_count; ++i)
+        {
+            single = single && near(octave(xs[i], ys[i]), noise(xs[i] * 0.5, ys[i] * 0.5));
+        }
+
+        expect(single, "a single octave of fractal noise");
+
+        const fractal_type fbm(seed, parameters_type{ .octave_count = 5, .warp_amplitude = 0.75 });
+        const fractal_type ridged(seed, parameters_type{ .octave_count = 5, .type = flow::fractal_type::ridged });
+
+        for (const fractal_type* fractal : { &fbm, &ridged })
+        {
+            const bool is_ridged = fractal->parameters().type == flow::fractal_type::ridged;
+
+            std::vector<double> values(point_count);
+            fractal->evaluate(std::span(xs), std::span(ys), std::span(values));
+
+            bool evaluated = true;
+
+            for (std::size_t i = 0; i < point_count; ++i)
+            {
+                evaluated = evaluated && near(values[i], (*fractal)(xs[i], ys[i]));
+            }
+
+            expect(evaluated, is_ridged ? "evaluating ridged noise" : "evaluating warped fbm noise");
+            expect(std::ranges::all_of(values, [=](double value) { return value <= 1.0 && value >= (is_ridged ? 0.0 : -1.0); }),
+                   is_ridged ? "ridged noise in [0, 1]" : "warped fbm noise in [-1, 1]");
+
+            // more rows than a band, so the threads split them
+            constexpr std::size_t rows = 70;
+
+            std::vector<double> grid(width * rows);
+            std::vector<double> parallel_grid(width * rows);
+            fractal->fill(std::span(grid), { -3.25, 1.5 }, { 0.125, 0.125 }, width, rows);
+            fractal->fill_parallel(std::span(parallel_grid), { -3.25, 1.5 }, { 0.125, 0.125 }, width, rows, thread_count);
+
+            expect(grid == parallel_grid && near(grid[rows / 2 * width + 3], (*fractal)(-3.25 + 3 * 0.125, 1.5 + rows / 2 * 0.125)),
+                   is_ridged ? "filling ridged noise" : "filling warped fbm noise");
+        }
+
+        FLOW_LOG_INFO("fractal noise: {} points, {} threads", point_count, thread_count);
+    }
+
+    // the batches and the xy slices give the values of single points, which stay in [-1, 1],
+    // change little over a short distance and depend on the seed
+    template<std::size_t N>
+    static void test_higher_dimensions()
+    {
+        constexpr double epsilon = 1e-4;
+
+        using noise_type = flow::noise_generator<N>;
+        using point_type = typename noise_type::generator_type::template point_type<double>;
+
+        const noise_type noise(seed);
+        const noise_type other_noise(seed + 1);
+
+        std::array<std::vector<double>, N> coordinates{};
+
+        for (std::size_t axis = 0; axis < N; ++axis)
+        {
+            coordinates[axis] = make_coordinates<double>(point_count, 0.0078125 * static_cast<double>(axis + 1), -9.5);
+        }
+
+        std::vector<double> values(point_count);
+
+        if constexpr (N == 3)
+        {
+            noise.evaluate(std::span<const double>(coordinates[0]),
+                           std::span<const double>(coordinates[1]),
+                           std::span<const double>(coordinates[2]),
+                           std::span(values));
+        }
+        else
+        {
+            noise.evaluate(std::span<const double>(coordinates[0]),
+                           std::span<const double>(coordinates[1]),
+                           std::span<const double>(coordinates[2]),
+                           std::span<const double>(coordinates[3]),
+                           std::span(values));
+        }
+
+        bool evaluated = true;
+        bool continuous = true;
+        bool seeded = false;
+        double largest = 0.0;
+
+        for (std::size_t i = 0; i < point_count; ++i)
+        {
+            point_type point{};
+
+            for (std::size_t axis = 0; axis < N; ++axis)
+            {
+                point[static_cast<glm::length_t>(axis)] = coordinates[axis][i];
+            }
+
+            evaluated = evaluated && near(values[i], noise(point));
+            seeded = seeded || values[i] != other_noise(point);
+            largest = std::max(largest, std::abs(values[i]));
+
+            for (std::size_t axis = 0; axis < N; ++axis)
+            {
+                point_type moved = point;
+                moved[static_cast<glm::length_t>(axis)] += epsilon;
+                continuous = continuous && std::abs(noise(moved) - values[i]) < epsilon * 100.0;
+            }
+        }
+
+        std::vector<double> grid(width * height);
+        point_type origin{};
+        origin.x = -3.25;
+        origin.y = 1.5;
+        origin.z = 0.75;
+
+        noise.generator().fill(std::span(grid), origin, { 0.125, 0.125 }, width, height);
+
+        point_type corner = origin;
+        corner.x += static_cast<double>(width - 1) * 0.125;
+        corner.y += static_cast<double>(height - 1) * 0.125;
+
+        if (!evaluated || !near(grid[0], noise(origin)) || !near(grid.back(), noise(corner)))
+        {
+            FLOW_LOG_ERROR("{}d noise: evaluate or fill doesn't match operator()", N);
+        }
+
+        if (largest > 1.0 || largest < 0.25 || !continuous || !seeded)
+        {
+            FLOW_LOG_ERROR("{}d noise: largest value {}, continuous {}, depends on the seed {}", N, largest, continuous, seeded);
+        }
+
+        FLOW_LOG_INFO("{}d noise: {} points, largest value {:.4f}", N, point_count, largest);
+    }
+
+    // the samples of the tiles are the noise, the points between them are interpolated from
+    // them, and neither the cached nor the queued tiles grow past the capacity
+    static void test_noise_field_cache()
+    {
+        constexpr std::size_t tile_size = 16;
+        constexpr double spacing = 0.25;
+        constexpr std::size_t capacity = 8;
+        constexpr std::size_t worker_count = 2;
+        constexpr std::size_t request_count = 100;
+
+        // the points of the requests are a few tiles apart
+        constexpr double tile_stride = static_cast<double>(tile_size) * spacing * 3.0;
+
+        const flow::noise_generator<2> noise(seed);
+        flow::noise_field_cache cache(noise, tile_size, spacing, capacity, worker_count);
+
+        bool on_samples = true;
+        bool between_samples = true;
+
+        for (std::size_t i = 0; i < point_count; ++i)
+        {
+            const double x = static_cast<double>((i * 37) % 200) * spacing - 20.0;
+            const double y = static_cast<double>((i * 53) % 120) * spacing - 10.0;
+
+            on_samples = on_samples && near(cache.sample(x, y), noise(x, y));
+
+            // bilinear interpolation stays between the samples around the point
+            const double corners[4]{ noise(x, y), noise(x + spacing, y), noise(x, y + spacing), noise(x + spacing, y + spacing) };
+            const double value = cache.sample(x + spacing * 0.375, y + spacing * 0.625);
+
+            between_samples = between_samples && value >= *std::ranges::min_element(corners) - tolerance<double>
+                && value <= *std::ranges::max_element(corners) + tolerance<double>;
+        }
+
+        expect(on_samples && between_samples, "sampling the noise field");
+        expect(cache.size() <= capacity && cache.contains({ 0, 0 }), "the cached tiles");
+
+        std::vector<double> rect(width * height);
+        cache.sample_rect(std::span(rect), { -3.25, 1.5 }, { 0.125, 0.125 }, width, height);
+        expect(rect[3 * width + 5] == cache.sample(-3.25 + 5 * 0.125, 1.5 + 3 * 0.125), "sampling a rectangle");
+
+        // a missing tile is queued and not waited for, the queue drops the oldest requests
+        std::size_t most_pending = 0;
+        std::size_t miss_count = 0;
+
+        for (std::size_t i = 0; i < request_count; ++i)
+        {
+            const std::optional<double> value = cache.try_sample({ static_cast<double>(i) * tile_stride + 1000.0, 0.0 });
+
+            miss_count += value ? 0 : 1;
+            most_pending = std::max(most_pending, cache.pending_count());
+        }
+
+        expect(miss_count > 0 && most_pending <= capacity, "queueing missing tiles");
+
+        const double far_x = 5000.0;
+        expect(!cache.try_sample({ far_x, 0.0 }) && near(cache.sample(far_x, 0.0), noise(far_x, 0.0)) && cache.try_sample({ far_x, 0.0 }),
+               "sampling a tile that was missing");
+        expect(cache.size() <= capacity, "dropping the least recently used tiles");
+
+        FLOW_LOG_INFO("noise field cache: {} of {} requests missed, at most {} pending", miss_count, request_count, most_pending);
+    }
+};
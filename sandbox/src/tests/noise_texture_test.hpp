@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/graphics/opengl/texture.hpp>
+#include <flow/graphics/texture/noise_texture_generator.hpp>
+#include <flow/utility/noise.hpp>
+#include <flow/utility/time.hpp>
+
+// fills a texture with the compute shader noise and compares it to the cpu noise of the same tables
+class noise_texture_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        const flow::open_simplex<2, float> noise(seed);
+
+        flow::noise_texture_generator generator;
+        flow::gl::texture2D texture;
+
+        if (!generator.create(noise) || !texture.create())
+        {
+            FLOW_LOG_ERROR("failed to create the noise texture generator");
+            engine.quit();
+            return;
+        }
+
+        texture.storage(1, flow::gl::texture_format::r32f, width, height);
+
+        const glm::vec2 origin{ -100.0F, 50.0F };
+        const glm::vec2 step{ 1.0F / 32.0F, 1.0F / 32.0F };
+
+        std::vector<float> gpu_values(width * height);
+        std::vector<float> cpu_values(width * height);
+
+        const auto gpu_start = flow::clock::now();
+        generator.fill(texture, origin, step, width, height);
+        texture.get_image(std::span(gpu_values), 0, flow::gl::pixel_format::red, flow::gl::type_value::gl_float);
+        const double gpu_time = flow::as_milliseconds<double>(flow::clock::now() - gpu_start);
+
+        const auto cpu_start = flow::clock::now();
+        noise.fill(std::span(cpu_values), origin, step, width, height);
+        const double cpu_time = flow::as_milliseconds<double>(flow::clock::now() - cpu_start);
+
+        float max_error = 0.0F;
+        std::size_t exact_count = 0;
+
+        for (std::size_t i = 0; i < cpu_values.size(); ++i)
+        {
+            const float error = std::abs(gpu_values[i] - cpu_values[i]);
+
+            max_error = std::max(max_error, error);
+            exact_count += error == 0.0F ? 1 : 0;
+        }
+
+        FLOW_LOG_INFO("{}x{} texels, gpu {:.2f} ms (with read back), cpu {:.2f} ms", width, height, gpu_time, cpu_time);
+        FLOW_LOG_INFO("max error {:.3e}, {} of {} texels are identical", max_error, exact_count, cpu_values.size());
+
+        if (max_error > max_allowed_error)
+        {
+            FLOW_LOG_ERROR("the gpu noise differs from the cpu noise by more than {}", max_allowed_error);
+        }
+
+        engine.quit();
+    }
+
+private:
+    static constexpr std::uint64_t seed = 42;
+    static constexpr std::size_t width = 2048;
+    static constexpr std::size_t height = 2048;
+    static constexpr float max_allowed_error = 1e-5F;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/math/vec2_math.hpp>
+#include <flow/utility/noise.hpp>
+#include <flow/utility/poisson_disk.hpp>
+#include <flow/utility/time.hpp>
+
+// times the uniform and the noise weighted poisson disk samplers,
+// and checks that no two points are closer than the minimum radius
+class poisson_disk_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        flow::poisson_disk_sampler uniform_sampler({ size, size }, min_radius);
+        flow::poisson_disk_sampler weighted_sampler({ size, size }, min_radius, max_radius);
+        const flow::float_noise_generator<2> noise(seed);
+
+        const auto uniform_start = flow::clock::now();
+        const std::size_t uniform_count = uniform_sampler.generate(seed).size();
+        const double uniform_time = flow::as_milliseconds<double>(flow::clock::now() - uniform_start);
+
+        const auto weighted_start = flow::clock::now();
+        const std::size_t weighted_count = weighted_sampler.generate(seed, noise, frequency).size();
+        const double weighted_time = flow::as_milliseconds<double>(flow::clock::now() - weighted_start);
+
+        FLOW_LOG_INFO("uniform: {} points in {:.2f} ms, {:.2f} million points per second",
+                      uniform_count,
+                      uniform_time,
+                      static_cast<double>(uniform_count) / uniform_time / 1000.0);
+        FLOW_LOG_INFO("weighted: {} points in {:.2f} ms, {:.2f} million points per second",
+                      weighted_count,
+                      weighted_time,
+                      static_cast<double>(weighted_count) / weighted_time / 1000.0);
+
+        const float uniform_distance = closest_distance(uniform_sampler.points());
+        const float weighted_distance = closest_distance(weighted_sampler.points());
+
+        FLOW_LOG_INFO("closest points: uniform {:.4f}, weighted {:.4f}", uniform_distance, weighted_distance);
+
+        if (uniform_distance < min_radius || weighted_distance < min_radius)
+        {
+            FLOW_LOG_ERROR("points closer than the minimum radius {}", min_radius);
+        }
+
+        engine.quit();
+    }
+
+private:
+    static constexpr std::uint64_t seed = 42;
+    static constexpr float size = 1000.0F;
+    static constexpr float min_radius = 1.0F;
+    static constexpr float max_radius = 4.0F;
+    static constexpr float frequency = 1.0F / 128.0F;
+
+    // sweeps the points sorted by x
+    static float closest_distance(std::span<const flow::vec2> points)
+    {
+        std::vector<flow::vec2> sorted(points.begin(), points.end());
+        std::ranges::sort(sorted, {}, &flow::vec2::x);
+
+        float closest = max_radius * 2.0F;
+
+        for (std::size_t i = 0; i < sorted.size(); ++i)
+        {
+            for (std::size_t j = i + 1; j < sorted.size() && sorted[j].x - sorted[i].x < closest; ++j)
+            {
+                closest = std::min(closest, flow::distance(sorted[i], sorted[j]));
+            }
+        }
+
+        return closest;
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/utility/random.hpp>
+
+#include "expect.hpp"
+
+// the sequences that must only depend on the seed, and the ranges and statistics of the
+// draws, every failed check is logged as an error
+class random_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        test_lanes();
+        test_stream_factory();
+        test_alias_table();
+        test_normal();
+
+        engine.quit();
+    }
+
+private:
+    static constexpr std::uint64_t seed = 42;
+
+    // the values are the ones of lane generators started a jump apart, interleaved, however
+    // the fills are split, then the ranges of the mapped values
+    static void test_lanes()
+    {
+        constexpr std::size_t count = 1000;
+        constexpr std::array<std::size_t, 6> fill_sizes{ 1, 3, 0, 7, 100, 500 };
+
+        using lanes_type = flow::xoshiro256pp_lanes<8>;
+
+        std::vector<flow::xoshiro256pp> lane_generators{};
+        flow::xoshiro256pp generator(seed);
+
+        for (std::size_t lane = 0; lane < lanes_type::lane_count; ++lane)
+        {
+            lane_generators.push_back(generator);
+            generator.jump();
+        }
+
+        std::vector<std::uint64_t> expected(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            expected[i] = lane_generators[i % lanes_type::lane_count]();
+        }
+
+        // split fills, single values and a fill of the rest
+        lanes_type lanes(seed);
+        std::vector<std::uint64_t> values(count);
+        std::size_t position = 0;
+
+        for (const std::size_t size : fill_sizes)
+        {
+            lanes.fill(std::span(values).subspan(position, size));
+            position += size;
+            values[position++] = lanes();
+        }
+
+        lanes.fill(std::span(values).subspan(position));
+        expect(values == expected, "lanes independent of the fill sizes");
+
+        std::vector<int> integers(count * 10);
+        lanes.fill(std::span(integers), -3, 5);
+
+        expect(std::ranges::all_of(integers, [](int value) { return value >= -3 && value <= 5; }), "integers in a closed range");
+
+        std::array<std::size_t, 9> integer_counts{};
+
+        for (const int value : integers)
+        {
+            ++integer_counts[static_cast<std::size_t>(std::clamp(value, -3, 5) + 3)];
+        }
+
+        expect(std::ranges::all_of(integer_counts, [&](std::size_t c) { return c > integers.size() / 10; }),
+               "drawing every integer of the range");
+
+        // at 1e8 the floats are 8 apart, so half of the values round up to max before the clamp
+        constexpr float min = 1e8F;
+        const float max = std::nextafter(min, 2e8F);
+
+        std::vector<float> floats(count);
+        lanes.fill(std::span(floats), min, max);
+        expect(std::ranges::all_of(floats, [=](float value) { return value >= min && value < max; }), "floats in a half open range");
+
+        lanes.fill(std::span(floats));
+        expect(std::ranges::all_of(floats, [](float value) { return value >= 0.0F && value < 1.0F; }), "floats in the unit range");
+
+        FLOW_LOG_INFO("lanes: {} values in {} lanes", count, lanes_type::lane_count);
+    }
+
+    static bool same_state(const flow::random_generator& lhs, const flow::xoshiro256pp& rhs)
+    {
+        return lhs.generator().state() == rhs.state();
+    }
+
+    // the generators handed out in order are the ones picked by index, a jump apart, and split
+    // factories start at the long jumps of their place in the tree
+    static void test_stream_factory()
+    {
+        constexpr std::size_t count = 4;
+        constexpr std::uint64_t split_stride = std::uint64_t{ 1 } << 48;   // the first digit of a root split
+        constexpr std::uint64_t nested_stride = std::uint64_t{ 1 } << 32;  // the second digit
+
+        flow::random_stream_factory root(seed);
+        const std::vector<flow::random_generator> generators = root.next(count);
+
+        flow::xoshiro256pp expected(seed);
+        bool in_order = true;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            in_order = in_order && same_state(generators[i], expected) && same_state(root.at(i), expected);
+            expected.jump();
+        }
+
+        expect(in_order && same_state(root.next(), expected), "generators a jump apart");
+
+        flow::random_stream_factory first = root.split();
+        const flow::random_stream_factory second = root.split();
+        const flow::random_stream_factory nested = first.split();
+
+        flow::xoshiro256pp first_base(seed);
+        first_base.long_jump(split_stride);
+
+        flow::xoshiro256pp second_base(seed);
+        second_base.long_jump(split_stride * 2);
+
+        flow::xoshiro256pp nested_base(seed);
+        nested_base.long_jump(split_stride + nested_stride);
+
+        expect(first.depth() == 1 && second.depth() == 1 && nested.depth() == 2, "the depth of split factories");
+        expect(same_state(first.at(0), first_base) && same_state(second.at(0), second_base) && same_state(nested.at(0), nested_base),
+               "split factories at their long jumps");
+
+        // the splits of a factory don't move its own generators
+        expect(same_state(root.at(0), flow::xoshiro256pp(seed)) && same_state(first.next(), first_base),
+               "splitting without moving the generators");
+
+        const std::array<const flow::random_stream_factory*, 4> factories{ &root, &first, &second, &nested };
+        std::vector<std::uint64_t> first_values{};
+
+        for (const flow::random_stream_factory* factory : factories)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                first_values.push_back(factory->at(i).next<std::uint64_t>());
+            }
+        }
+
+        std::ranges::sort(first_values);
+        expect(std::ranges::adjacent_find(first_values) == first_values.end(), "distinct generators across the splits");
+
+        FLOW_LOG_INFO("stream factory: {} generators in {} factories", first_values.size(), factories.size());
+    }
+
+    // the frequencies of the indices against their weights, a weight of zero is never picked,
+    // and the batch draws are the single ones in order
+    static void test_alias_table()
+    {
+        constexpr std::size_t count = 100000;
+        constexpr double tolerance = 0.01;
+
+        const std::vector<int> weights{ 1, 0, 3, 6 };
+        const flow::alias_table table(weights);
+
+        flow::random_generator generator(seed);
+        std::vector<std::uint32_t> indices(count);
+        generator.pick_n(std::span(indices), table);
+
+        std::array<std::size_t, 4> counts{};
+
+        for (const std::uint32_t index : indices)
+        {
+            ++counts[std::min<std::size_t>(index, counts.size() - 1)];
+        }
+
+        bool frequencies = counts[1] == 0;
+
+        for (std::size_t i = 0; i < weights.size(); ++i)
+        {
+            const double frequency = static_cast<double>(counts[i]) / static_cast<double>(count);
+            frequencies = frequencies && std::abs(frequency - static_cast<double>(weights[i]) / 10.0) < tolerance;
+        }
+
+        expect(table.size() == weights.size() && frequencies, "alias table frequencies");
+
+        flow::random_generator single(seed);
+        expect(std::ranges::all_of(indices, [&](std::uint32_t index) { return single.pick(table) == index; }),
+               "batch picks in order");
+
+        const flow::alias_table one(std::vector<double>{ 0.5 });
+        expect(one.size() == 1 && generator.pick(one) == 0 && flow::alias_table{}.empty(), "tables of one and no weights");
+
+        FLOW_LOG_INFO("alias table: {} picks, counts {} {} {} {}", count, counts[0], counts[1], counts[2], counts[3]);
+    }
+
+    // the moments and the tails of the ziggurat draws, and the batch draws are the single ones
+    static void test_normal()
+    {
+        constexpr std::size_t count = 200000;
+        constexpr double mean = 2.0;
+        constexpr double stddev = 3.0;
+
+        flow::random_generator generator(seed);
+        std::vector<double> values(count);
+        generator.normal_n(std::span(values), mean, stddev);
+
+        double sum = 0.0;
+        double sum2 = 0.0;
+        std::size_t within_one = 0;
+        std::size_t beyond_three = 0;
+
+        for (const double value : values)
+        {
+            const double z = (value - mean) / stddev;
+
+            sum += value;
+            sum2 += (value - mean) * (value - mean);
+            within_one += std::abs(z) < 1.0 ? 1 : 0;
+            beyond_three += std::abs(z) > 3.0 ? 1 : 0;
+        }
+
+        const double sample_mean = sum / static_cast<double>(count);
+        const double sample_stddev = std::sqrt(sum2 / static_cast<double>(count));
+
+        expect(std::abs(sample_mean - mean) < 0.03 && std::abs(sample_stddev - stddev) < 0.03, "normal mean and deviation");
+
+        // 68.27% within one deviation and 0.27% beyond three, which come from the tail of the ziggurat
+        const double one_fraction = static_cast<double>(within_one) / static_cast<double>(count);
+        const double three_fraction = static_cast<double>(beyond_three) / static_cast<double>(count);
+        expect(std::abs(one_fraction - 0.6827) < 0.005 && three_fraction > 0.002 && three_fraction < 0.0035, "normal tails");
+
+        flow::random_generator single(seed);
+        const flow::ziggurat_normal_distribution<double> distribution(mean, stddev);
+        expect(std::ranges::all_of(values, [&](double value) { return single.sample(distribution) == value; }),
+               "batch normal draws in order");
+
+        FLOW_LOG_INFO("normal: {} draws, mean {:.4f}, deviation {:.4f}", count, sample_mean, sample_stddev);
+    }
+};
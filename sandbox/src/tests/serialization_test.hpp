@@ -0,0 +1,314 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/utility/aggregate_serialization.hpp>
+#include <flow/utility/chunk_container.hpp>
+#include <flow/utility/fixed_point.hpp>
+#include <flow/utility/istream_view.hpp>
+#include <flow/utility/memory_istream.hpp>
+#include <flow/utility/memory_ostream.hpp>
+#include <flow/utility/ostream_view.hpp>
+#include <flow/utility/string_serialization.hpp>
+#include <flow/utility/vector_serialization.hpp>
+
+#include "expect.hpp"
+
+namespace serialization_test_types {
+
+struct position
+{
+    float x;
+    float y;
+};
+
+// the same structure as position, under a name
+struct named_position
+{
+    float x;
+    float y;
+};
+
+struct owner
+{
+    std::string name;
+    std::uint32_t id;
+};
+
+// members that are copied in runs, serialized one by one and nested
+struct record
+{
+    std::uint32_t id;
+    float weight;
+    double score;
+    std::vector<int> values;
+    char grade;
+    owner owned_by;
+    std::array<std::uint16_t, 3> codes;
+};
+
+enum class direction : std::uint16_t
+{
+    north = 0x0102,
+    south = 0x0304,
+};
+
+// a nested aggregate with padding after flag and after the inner position
+struct segment
+{
+    std::uint8_t flag;
+    position start;
+    direction heading;
+    std::array<std::uint32_t, 2> ids;
+};
+
+} // namespace serialization_test_types
+
+template<>
+struct flow::serializer<serialization_test_types::record> : flow::aggregate_serializer<serialization_test_types::record>
+{};
+
+template<>
+struct flow::deserializer<serialization_test_types::record> : flow::aggregate_deserializer<serialization_test_types::record>
+{};
+
+template<>
+struct flow::chunk_type<serialization_test_types::named_position>
+{
+    static constexpr std::string_view name = "named_position";
+    static constexpr std::uint32_t version = 1;
+};
+
+// round trips through the serialization formats, with seeks and the reads that must fail,
+// every failed check is logged as an error
+class serialization_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        test_chunk_container();
+        test_aggregate_serialization();
+        test_byte_order();
+
+        engine.quit();
+    }
+
+private:
+    using position = serialization_test_types::position;
+    using named_position = serialization_test_types::named_position;
+    using record = serialization_test_types::record;
+    using direction = serialization_test_types::direction;
+    using segment = serialization_test_types::segment;
+
+    static constexpr std::endian foreign_byte_order = std::endian::native == std::endian::little ? std::endian::big
+                                                                                                : std::endian::little;
+
+    // the chunks are read back in a different order than they were written, and a container
+    // that doesn't start at the beginning of the stream
+    static void test_chunk_container()
+    {
+        constexpr std::string_view prefix = "prefix";
+        constexpr std::uint32_t version = 7;
+
+        const std::vector<int> values{ 1, 2, 3, 5, 8 };
+        const std::string name = "chunks";
+        const position point{ 1.5F, -2.0F };
+        const named_position named_point{ 3.0F, 4.0F };
+
+        std::stringstream ss{};
+        ss << prefix;
+
+        flow::chunk_writer writer{};
+        expect(writer.begin(ss, version), "chunk_writer::begin");
+        expect(writer.write("values", values), "writing a vector chunk");
+        expect(writer.write("name", name), "writing a string chunk");
+        expect(writer.write("point", point), "writing an aggregate chunk");
+        expect(writer.write("named_point", named_point), "writing a named chunk");
+        expect(writer.end(), "chunk_writer::end");
+
+        const std::string bytes = ss.str();
+
+        std::stringstream in_ss(bytes);
+        flow::istream_view in(in_ss);
+        in.seek(static_cast<flow::istream_view::pos_type>(prefix.size()));
+
+        flow::chunk_reader reader{};
+        expect(reader.open(in), "chunk_reader::open");
+        expect(reader.version() == version && reader.entries().size() == 4, "chunk container header");
+
+        named_position read_named_point{};
+        expect(reader.read("named_point", read_named_point) && read_named_point.y == named_point.y, "named chunk round trip");
+
+        position read_point{};
+        expect(reader.read("point", read_point) && read_point.x == point.x && read_point.y == point.y, "aggregate chunk round trip");
+
+        std::vector<int> read_values{};
+        expect(reader.read("values", read_values) && read_values == values, "vector chunk round trip");
+
+        // a chunk read by hand after seeking to it
+        std::string read_name{};
+        expect(reader.seek("name") != nullptr && in.deserialize(read_name) && read_name == name, "seeking to a chunk");
+
+        // the types are checked before reading
+        std::vector<float> wrong_values{};
+        expect(!reader.read("values", wrong_values) && wrong_values.empty(), "reading a chunk as another type");
+
+        position unnamed_point{};
+        expect(!reader.read("named_point", unnamed_point), "reading a named chunk as an unnamed type");
+        expect(!reader.contains("missing") && !reader.read("missing", read_values), "reading a missing chunk");
+
+        // the container starts after the prefix
+        std::stringstream prefixed(bytes);
+        expect(!flow::chunk_reader{}.open(flow::istream_view(prefixed)), "opening a container at the wrong position");
+
+        // the table is at the end, so a cut container can't be opened
+        std::stringstream truncated(bytes.substr(0, bytes.size() - 1));
+        flow::istream_view truncated_in(truncated);
+        truncated_in.seek(static_cast<flow::istream_view::pos_type>(prefix.size()));
+        expect(!flow::chunk_reader{}.open(truncated_in), "opening a truncated container");
+
+        // a forged count of chunks that the stream can't hold
+        std::string forged = bytes;
+        const std::uint32_t forged_count = std::numeric_limits<std::uint32_t>::max();
+        std::memcpy(forged.data() + prefix.size() + offsetof(flow::detail::chunk_container_header, chunk_count),
+                    &forged_count,
+                    sizeof(forged_count));
+
+        std::stringstream forged_ss(forged);
+        flow::istream_view forged_in(forged_ss);
+        forged_in.seek(static_cast<flow::istream_view::pos_type>(prefix.size()));
+        expect(!flow::chunk_reader{}.open(forged_in), "opening a container with a forged chunk count");
+
+        FLOW_LOG_INFO("chunk container: {} bytes, {} chunks", bytes.size() - prefix.size(), reader.entries().size());
+    }
+
+    static bool equal(const record& lhs, const record& rhs)
+    {
+        return lhs.id == rhs.id && lhs.weight == rhs.weight && lhs.score == rhs.score && lhs.values == rhs.values
+            && lhs.grade == rhs.grade && lhs.owned_by.name == rhs.owned_by.name && lhs.owned_by.id == rhs.owned_by.id
+            && lhs.codes == rhs.codes;
+    }
+
+    // a vector of records and a single one after it, which is read first by seeking to it
+    static void test_aggregate_serialization()
+    {
+        const std::vector<record> records{
+            { 1, 0.5F, 2.25, { 1, 2, 3 }, 'a', { "first", 10 }, { 1, 2, 3 } },
+            { 2, 1.5F, -4.0, {}, 'b', { "", 20 }, { 4, 5, 6 } },
+        };
+        const record last{ 3, 2.5F, 8.0, { 42 }, 'c', { "last", 30 }, { 7, 8, 9 } };
+
+        std::stringstream ss{};
+        flow::ostream_view out(ss);
+
+        out.serialize(records);
+        const auto last_position = out.tell();
+        out.serialize(last);
+        expect(static_cast<bool>(out), "serializing aggregates");
+
+        const std::string bytes = ss.str();
+
+        std::stringstream in_ss(bytes);
+        flow::istream_view in(in_ss);
+
+        record read_last{};
+        in.seek(static_cast<flow::istream_view::pos_type>(last_position)).deserialize(read_last);
+        expect(in && equal(read_last, last), "aggregate round trip after a seek");
+
+        std::vector<record> read_records{};
+        in.seek(0).deserialize(read_records);
+        expect(in && read_records.size() == records.size() && equal(read_records[0], records[0]) && equal(read_records[1], records[1]),
+               "vector of aggregates round trip");
+
+        // without its last bytes, the codes of the last record are incomplete
+        std::stringstream truncated(bytes.substr(0, bytes.size() - sizeof(last.codes) - 1));
+        flow::istream_view truncated_in(truncated);
+        record truncated_last{};
+        truncated_in.seek(static_cast<flow::istream_view::pos_type>(last_position)).deserialize(truncated_last);
+        expect(!truncated_in, "deserializing a truncated aggregate");
+
+        FLOW_LOG_INFO("aggregate serialization: {} records in {} bytes", records.size() + 1, bytes.size());
+    }
+
+    static bool equal(const segment& lhs, const segment& rhs)
+    {
+        return lhs.flag == rhs.flag && lhs.start.x == rhs.start.x && lhs.start.y == rhs.start.y && lhs.heading == rhs.heading
+            && lhs.ids == rhs.ids;
+    }
+
+    static std::size_t written_size(const segment& segment_value, const record& record_value, std::endian order)
+    {
+        std::stringstream ss{};
+        flow::ostream_view(ss).set_byte_order(order).write(segment_value).serialize(record_value);
+
+        return ss.str().size();
+    }
+
+    // values, spans, nested aggregates and serialized records in the foreign byte order, read back
+    // after seeking into the middle, and the types that can't be converted
+    static void test_byte_order()
+    {
+        const std::vector<float> values{ 0.5F, -1.0F, 3.25F, 1e-3F, 1e8F };
+        const segment first{ 1, { 1.5F, 2.5F }, direction::north, { 7, 8 } };
+        const segment second{ 2, { -3.0F, 4.0F }, direction::south, { 0x01020304, 9 } };
+        const record value{ 4, 3.5F, -0.125, { 1, -2 }, 'd', { "swapped", 0x0a0b0c0d }, { 1, 0x0102, 3 } };
+
+        std::vector<std::byte> memory(1024);
+        flow::memory_ostream memory_out(memory);
+        flow::ostream_view out(memory_out);
+        out.set_byte_order(foreign_byte_order);
+
+        out.write(std::uint32_t{ 0x01020304 }).write(std::span(values)).write(first);
+        const auto second_position = out.tell();
+        out.write(second).serialize(value);
+        expect(static_cast<bool>(out), "writing in the foreign byte order");
+
+        const std::span<const std::byte> bytes = memory_out.written();
+        const std::byte first_byte = foreign_byte_order == std::endian::big ? std::byte{ 0x01 } : std::byte{ 0x04 };
+        expect(!bytes.empty() && bytes.front() == first_byte, "the byte order of a written value");
+
+        flow::memory_istream memory_in(bytes);
+        flow::istream_view in(memory_in);
+        in.set_byte_order(foreign_byte_order);
+
+        segment read_second{};
+        record read_value{};
+        in.seek(static_cast<flow::istream_view::pos_type>(second_position)).read(read_second).deserialize(read_value);
+        expect(in && equal(read_second, second) && equal(read_value, value), "foreign byte order round trip after a seek");
+
+        std::uint32_t read_marker{};
+        std::vector<float> read_values(values.size());
+        segment read_first{};
+        in.seek(0).read(read_marker).read(std::span(read_values)).read(read_first);
+        expect(in && read_marker == 0x01020304 && read_values == values && equal(read_first, first), "foreign byte order round trip");
+
+        // nested aggregates keep their layout, padding included, in both byte orders
+        expect(written_size(first, value, std::endian::native) == written_size(first, value, foreign_byte_order),
+               "the same layout in both byte orders");
+
+        // values can't be viewed in place in the foreign byte order
+        std::span<const float> view{};
+        in.seek(static_cast<flow::istream_view::pos_type>(sizeof(std::uint32_t))).view(view, values.size());
+        expect(!in, "viewing values in the foreign byte order");
+
+        // fixed16_16_t holds a private value that can't be swapped
+        flow::fixed16_16_t fixed(1.5);
+        expect(!flow::ostream_view(memory_out).set_byte_order(foreign_byte_order).write(fixed), "writing an opaque type in the foreign byte order");
+
+        flow::memory_istream fixed_in(bytes);
+        expect(!flow::istream_view(fixed_in).set_byte_order(foreign_byte_order).read(fixed), "reading an opaque type in the foreign byte order");
+
+        FLOW_LOG_INFO("byte order: {} bytes in {} endian", bytes.size(), foreign_byte_order == std::endian::big ? "big" : "little");
+    }
+};
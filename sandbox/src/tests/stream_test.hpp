@@ -0,0 +1,588 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+#include <ios>
+#include <span>
+#include <string>
+#include <sstream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <flow/core/application.hpp>
+#include <flow/core/logger.hpp>
+#include <flow/utility/async_sliding_stream_buffer.hpp>
+#include <flow/utility/file_stream.hpp>
+#include <flow/utility/iostream_view.hpp>
+#include <flow/utility/lz4.hpp>
+#include <flow/utility/lz4_stream.hpp>
+#include <flow/utility/istream_view.hpp>
+#include <flow/utility/mapped_file.hpp>
+#include <flow/utility/mapped_sliding_buffer.hpp>
+#include <flow/utility/memory_istream.hpp>
+#include <flow/utility/memory_ostream.hpp>
+#include <flow/utility/ostream_view.hpp>
+#include <flow/utility/sliding_stream_buffer.hpp>
+#include <flow/utility/stream_algorithm.hpp>
+#include <flow/utility/stream_page_index.hpp>
+
+#include "expect.hpp"
+
+// round trips through the stream backends and the buffers built on them, with seeks and the
+// reads that must fail, every failed check is logged as an error
+class stream_test final : public flow::application
+{
+public:
+    void start() final
+    {
+        test_file_stream();
+        test_memory_streams();
+        test_mapped_sliding_buffer();
+        test_sliding_stream_buffer();
+        test_async_sliding_stream_buffer();
+        test_stream_page_index();
+        test_stream_bounds();
+        test_lz4();
+        test_lz4_stream();
+
+        std::filesystem::remove(path);
+
+        engine.quit();
+    }
+
+private:
+    static inline const std::filesystem::path path = std::filesystem::temp_directory_path() / "flow_stream_test.bin";
+
+    static constexpr std::size_t value_count = 10000;
+    static constexpr std::size_t header_size = sizeof(std::uint64_t);
+
+    static std::vector<std::uint32_t> make_values(std::size_t count)
+    {
+        std::vector<std::uint32_t> values(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] = static_cast<std::uint32_t>(i * 7 + 3);
+        }
+
+        return values;
+    }
+
+    // sorted, with runs of equal values and gaps between them
+    static std::vector<std::uint32_t> make_sorted_values(std::size_t count)
+    {
+        std::vector<std::uint32_t> values(count);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] = static_cast<std::uint32_t>(i / 3 * 5);
+        }
+
+        return values;
+    }
+
+    // the values after a header, as the sliding buffers expect them
+    static void write_values(std::span<const std::uint32_t> values)
+    {
+        flow::file_stream file(path, std::ios_base::out | std::ios_base::trunc);
+        flow::ostream_view(file).write(std::uint64_t{ values.size() }).write(values);
+    }
+
+    // the values of a window are the ones at the same indices
+    static bool matches(std::span<const std::uint32_t> window, std::size_t begin, std::span<const std::uint32_t> values)
+    {
+        return begin + window.size() <= values.size() && std::ranges::equal(window, values.subspan(begin, window.size()));
+    }
+
+    // a buffer much smaller than the writes and reads, so both cross it, and a write in the
+    // middle of the file after a seek
+    static void test_file_stream()
+    {
+        constexpr std::size_t buffer_size = 61;
+        constexpr std::size_t middle = 5000;
+
+        std::vector<std::uint32_t> values = make_values(value_count);
+
+        flow::file_stream file(path, std::ios_base::in | std::ios_base::out | std::ios_base::trunc, buffer_size);
+        expect(file.is_open(), "opening a file stream");
+
+        flow::iostream_view io(file);
+        io.write(std::span<const std::uint32_t>(values));
+
+        values[middle] = 42;
+        io.seekp(static_cast<flow::iostream_view::pos_type>(middle * sizeof(std::uint32_t))).write(values[middle]);
+        expect(io && io.tellp() == static_cast<flow::iostream_view::pos_type>((middle + 1) * sizeof(std::uint32_t)),
+               "writing after a seek");
+
+        std::uint32_t value{};
+        io.seekg(static_cast<flow::iostream_view::pos_type>(middle * sizeof(std::uint32_t))).read(value);
+        expect(io && value == 42, "reading back a write in the buffer");
+
+        expect(file.close(), "closing a file stream");
+
+        flow::file_stream in_file(path, std::ios_base::in, buffer_size);
+        flow::istream_view in(in_file);
+
+        std::vector<std::uint32_t> read_values(value_count);
+        in.read(std::span(read_values));
+        expect(in && read_values == values, "file stream round trip");
+
+        in.seek(0, flow::istream_view::end);
+        expect(in.tell() == static_cast<flow::istream_view::pos_type>(value_count * sizeof(std::uint32_t)), "seeking to the end");
+
+        // the last value is there, the one after it isn't
+        in.seek(-static_cast<flow::istream_view::off_type>(sizeof(std::uint32_t)), flow::istream_view::end).read(value);
+        expect(in && value == values.back(), "reading the last value");
+        expect(!in.read(value), "reading past the end of a file");
+
+        flow::file_stream missing(path / "missing.bin", std::ios_base::in);
+        expect(!missing.is_open(), "opening a missing file");
+
+        FLOW_LOG_INFO("file stream: {} values through a {} byte buffer", value_count, buffer_size);
+    }
+
+    // a fixed span that the writes can't grow past
+    static void test_memory_streams()
+    {
+        std::vector<std::byte> memory(sizeof(std::uint64_t) + sizeof(std::uint32_t));
+        flow::memory_ostream memory_out(memory);
+        flow::ostream_view out(memory_out);
+
+        out.write(std::uint64_t{ 1 }).write(std::uint32_t{ 2 });
+        expect(out && memory_out.written().size() == memory.size(), "writing to memory");
+
+        out.write(std::uint32_t{ 3 });
+        expect(out.bad(), "writing past the end of memory");
+
+        flow::memory_istream memory_in{ std::span<const std::byte>(memory) };
+        flow::istream_view in(memory_in);
+
+        std::uint32_t second{};
+        std::uint64_t first{};
+        in.seek(sizeof(std::uint64_t)).read(second);
+        in.seek(0).read(first);
+        expect(in && first == 1 && second == 2, "memory round trip after a seek");
+
+        in.seek(sizeof(std::uint64_t)).read(first);
+        expect(!in, "reading past the end of memory");
+
+        FLOW_LOG_INFO("memory streams: {} bytes", memory.size());
+    }
+
+    // moves in both directions and jumps, the buffer claims more values than the file holds,
+    // so the last window is cut short
+    static void test_mapped_sliding_buffer()
+    {
+        constexpr std::size_t window_size = 1000;
+        constexpr std::size_t missing_count = 100;
+
+        const std::vector<std::uint32_t> values = make_values(value_count);
+        write_values(values);
+
+        flow::mapped_file file(path);
+        expect(file.is_open() && file.size() == header_size + value_count * sizeof(std::uint32_t), "mapping a file");
+
+        flow::mapped_sliding_buffer<std::uint32_t> buffer(file, header_size, value_count + missing_count, window_size);
+
+        buffer.load();
+        expect(buffer.values().size() == window_size && matches(buffer.values(), buffer.begin(), values), "loading the first window");
+
+        buffer.forward(2500);
+        buffer.load();
+        expect(buffer.begin() == 2500 && matches(buffer.values(), buffer.begin(), values), "moving forward");
+
+        buffer.backward(700);
+        buffer.load();
+        expect(buffer.begin() == 1800 && matches(buffer.values(), buffer.begin(), values), "moving backward");
+
+        // the window stops at the claimed end, the missing values past the file aren't loaded
+        buffer.set_begin(value_count);
+        buffer.load();
+        expect(buffer.end() == value_count + missing_count && buffer.loaded_size() == window_size - missing_count
+                   && matches(buffer.values(), buffer.begin(), values),
+               "loading a window past the end of the file");
+
+        flow::mapped_file missing(path / "missing.bin");
+        expect(!missing.is_open() && missing.bytes().empty(), "mapping a missing file");
+
+        FLOW_LOG_INFO("mapped sliding buffer: {} values, windows of {}", value_count, window_size);
+    }
+
+    // edits made before moving the window are saved with it, and read back from the file, a
+    // reload reads the values written around the buffer, a window past the end of the file fails
+    static void test_sliding_stream_buffer()
+    {
+        constexpr std::size_t buffer_size = 127;
+        constexpr std::size_t window_size = 500;
+        constexpr std::uint32_t edited = 0xffffffff;
+
+        std::vector<std::uint32_t> values = make_values(value_count);
+        write_values(values);
+
+        flow::file_stream file(path, std::ios_base::in | std::ios_base::out, buffer_size);
+        flow::iostream_view io(file);
+
+        flow::sliding_stream_buffer<std::uint32_t> buffer(header_size, value_count, window_size);
+        buffer.load(io);
+        expect(io && matches(std::as_const(buffer).values(), buffer.begin(), values), "loading the first window");
+
+        // the edits stay in the window after moving it, and are saved from there
+        for (std::uint32_t& value : buffer.values(10, 5))
+        {
+            value = edited;
+        }
+
+        std::fill_n(values.begin() + 10, 5, edited);
+
+        buffer.forward(8);
+        buffer.load(io);
+        expect(buffer.is_dirty() && matches(std::as_const(buffer).values(), buffer.begin(), values), "moving a dirty window");
+
+        buffer.save(io);
+        expect(io && !buffer.is_dirty(), "saving a window");
+
+        buffer.set_begin(value_count);
+        buffer.load(io);
+        buffer.values(window_size - 1, 1)[0] = edited;
+        values.back() = edited;
+        buffer.save(io);
+
+        buffer.set_begin(0);
+        buffer.load(io);
+        expect(io && matches(std::as_const(buffer).values(), buffer.begin(), values), "reading back a saved window");
+
+        // a value written past the buffer is only read by a reload, a dirty one is discarded by it
+        constexpr std::uint32_t written = 0xfffffffe;
+
+        io.seekp(header_size + 3 * sizeof(std::uint32_t)).write(written);
+        buffer.values(4, 1)[0] = edited;
+        buffer.load(io);
+        expect(io && std::as_const(buffer).values()[3] == values[3] && std::as_const(buffer).values()[4] == edited,
+               "loading the same window");
+
+        values[3] = written;
+        buffer.reload(io);
+        expect(io && !buffer.is_dirty() && matches(std::as_const(buffer).values(), buffer.begin(), values), "reloading a window");
+
+        expect(file.close(), "closing the edited file");
+
+        flow::file_stream in_file(path, std::ios_base::in);
+        std::vector<std::uint32_t> read_values(value_count);
+        flow::istream_view(in_file).seek(header_size).read(std::span(read_values));
+        expect(read_values == values, "sliding stream buffer round trip");
+
+        // the buffer claims more values than the file holds
+        flow::istream_view in(in_file);
+        flow::sliding_stream_buffer<std::uint32_t> long_buffer(header_size, value_count + 1, window_size);
+        long_buffer.set_begin(value_count);
+        long_buffer.load(in);
+        expect(!in, "loading a window past the end of the file");
+
+        FLOW_LOG_INFO("sliding stream buffer: {} values, windows of {}", value_count, window_size);
+    }
+
+    // a steady movement is served from the prefetched windows, a jump is read again,
+    // and a window past the end of the file fails
+    static void test_async_sliding_stream_buffer()
+    {
+        constexpr std::size_t window_size = 500;
+        constexpr std::size_t step_count = 10;
+
+        const std::vector<std::uint32_t> values = make_values(value_count);
+        write_values(values);
+
+        std::size_t hit_count = 0;
+
+        {
+            flow::file_stream file(path, std::ios_base::in);
+            flow::async_sliding_stream_buffer<std::uint32_t> buffer(file, header_size, value_count, window_size);
+
+            expect(buffer.load() == flow::sliding_load_status::miss && matches(buffer.values(), buffer.begin(), values),
+                   "loading the first window");
+
+            for (std::size_t i = 0; i < step_count; ++i)
+            {
+                buffer.forward(window_size / 2);
+
+                const flow::sliding_load_status status = buffer.load();
+                hit_count += status == flow::sliding_load_status::hit ? 1 : 0;
+
+                expect(status != flow::sliding_load_status::failed && matches(buffer.values(), buffer.begin(), values),
+                       "moving forward");
+            }
+
+            buffer.set_begin(value_count / 3);
+            expect(buffer.load() == flow::sliding_load_status::miss && matches(buffer.values(), buffer.begin(), values),
+                   "jumping to a window");
+        }
+
+        expect(hit_count + 1 >= step_count, "prefetching the next window");
+
+        {
+            flow::file_stream file(path, std::ios_base::in);
+            flow::async_sliding_stream_buffer<std::uint32_t> buffer(file, header_size, value_count + 1, window_size);
+
+            buffer.set_begin(value_count);
+            expect(buffer.load() == flow::sliding_load_status::failed, "loading a window past the end of the file");
+        }
+
+        FLOW_LOG_INFO("async sliding stream buffer: {} of {} steps prefetched", hit_count, step_count);
+    }
+
+    // lookups with small pages, so the index has several levels, with and without a cache,
+    // the index doesn't start at the beginning of its stream, and lookups of missing values fail
+    static void test_stream_page_index()
+    {
+        constexpr std::size_t page_size = 64;
+        constexpr std::string_view prefix = "prefix";
+
+        const std::vector<std::uint32_t> values = make_sorted_values(value_count);
+
+        std::stringstream data_ss{};
+        flow::ostream_view(data_ss).write(std::uint64_t{ values.size() }).write(std::span(values));
+
+        std::stringstream index_ss{};
+        index_ss << prefix;
+
+        using index_type = flow::stream_page_index<std::uint32_t>;
+        expect(index_type::write(data_ss, header_size, values.size(), index_ss, page_size), "writing a page index");
+
+        std::size_t level_count = 0;
+
+        for (std::size_t cache_size : { std::size_t{ 0 }, index_type::default_cache_size })
+        {
+            index_type index{};
+            expect(index.open(index_ss, prefix.size(), data_ss, header_size, cache_size), "opening a page index");
+
+            level_count = index.level_count();
+
+            bool found = true;
+
+            for (std::uint32_t key = 0; key <= values.back() + 1; ++key)
+            {
+                const auto lower = static_cast<std::size_t>(std::ranges::lower_bound(values, key) - values.begin());
+                const auto upper = static_cast<std::size_t>(std::ranges::upper_bound(values, key) - values.begin());
+
+                found = found && index.lower_bound(key) == lower && index.upper_bound(key) == upper;
+            }
+
+            expect(found, "page index lookups");
+        }
+
+        expect(level_count > 1, "a page index with several levels");
+
+        // the header is at the prefix, and holds the size of the values
+        expect(!index_type{}.open(index_ss, 0, data_ss, header_size), "opening a page index at the wrong position");
+        expect(!flow::stream_page_index<std::uint64_t>{}.open(index_ss, prefix.size(), data_ss, header_size),
+               "opening a page index of another type");
+
+        // the values of the second half are missing, the lookups of the first half still work
+        index_ss.clear();
+        std::stringstream half_ss(data_ss.str().substr(0, header_size + values.size() / 2 * sizeof(std::uint32_t)));
+
+        index_type half_index{};
+        expect(half_index.open(index_ss, prefix.size(), half_ss, header_size, 0), "opening a page index of missing values");
+        expect(!half_index.lower_bound(values.back()) && half_index.lower_bound(values.front()) == 0,
+               "a lookup of missing values");
+
+        FLOW_LOG_INFO("stream page index: {} values, {} levels", values.size(), level_count);
+    }
+
+    // the bounds of sorted keys against the ones of std, for the results of the lookups
+    // of every key
+    static bool equal_bounds(std::span<const std::uint32_t> values,
+                             std::span<const std::uint32_t> keys,
+                             std::span<const std::size_t> lower,
+                             std::span<const std::size_t> upper)
+    {
+        if (lower.size() != keys.size() || upper.size() != keys.size())
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            if (lower[i] != static_cast<std::size_t>(std::ranges::lower_bound(values, keys[i]) - values.begin())
+                || upper[i] != static_cast<std::size_t>(std::ranges::upper_bound(values, keys[i]) - values.begin()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // dense keys, which are merged with a single pass over the values, and sparse keys, which
+    // are bisected, then values cut short
+    static void test_stream_bounds()
+    {
+        // enough values for a few keys to be cheaper to bisect than to merge
+        constexpr std::size_t count = std::size_t{ 1 } << 20;
+        constexpr std::size_t dense_step = 16;
+
+        const std::vector<std::uint32_t> values = make_sorted_values(count);
+
+        std::stringstream ss{};
+        flow::ostream_view(ss).write(std::uint64_t{ values.size() }).write(std::span(values));
+        const std::string bytes = ss.str();
+
+        std::vector<std::uint32_t> dense_keys{};
+
+        for (std::uint32_t key = 0; key <= values.back() + 1; key += dense_step)
+        {
+            dense_keys.push_back(key);
+        }
+
+        const std::vector<std::uint32_t> sparse_keys{ 0, 4, 5, 6, 1000, values.back(), values.back() + 1 };
+
+        expect(flow::detail::stream_prefer_merge(count, dense_keys.size(), sizeof(std::uint32_t))
+                   && !flow::detail::stream_prefer_merge(count, sparse_keys.size(), sizeof(std::uint32_t)),
+               "choosing between merging and bisecting");
+
+        for (const std::vector<std::uint32_t>& keys : { dense_keys, sparse_keys })
+        {
+            std::vector<std::size_t> lower{};
+            std::vector<std::size_t> upper{};
+
+            flow::stream_lower_bounds(ss, header_size, 0, values.size(), keys, std::back_inserter(lower));
+            flow::stream_upper_bounds(ss, header_size, 0, values.size(), keys, std::back_inserter(upper));
+
+            expect(ss && equal_bounds(values, keys, lower, upper),
+                   keys.size() == dense_keys.size() ? "dense stream bounds" : "sparse stream bounds");
+        }
+
+        // the last value is missing
+        std::stringstream truncated(bytes.substr(0, bytes.size() - sizeof(std::uint32_t)));
+        std::vector<std::size_t> truncated_lower{};
+        flow::stream_lower_bounds(truncated, header_size, 0, values.size(), dense_keys, std::back_inserter(truncated_lower));
+        expect(!truncated, "the bounds of values cut short");
+
+        FLOW_LOG_INFO("stream bounds: {} values, {} dense and {} sparse keys", values.size(), dense_keys.size(), sparse_keys.size());
+    }
+
+    // compressible and incompressible blocks, then the inputs that must be rejected
+    static void test_lz4()
+    {
+        constexpr std::size_t error = std::numeric_limits<std::size_t>::max();
+        constexpr std::size_t size = 4096;
+
+        std::vector<std::byte> repeated(size);
+        std::vector<std::byte> mixed(size);
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            repeated[i] = static_cast<std::byte>(i % 7);
+            mixed[i] = static_cast<std::byte>((i * 2654435761U) >> 13U);
+        }
+
+        std::vector<std::byte> compressed(flow::lz4_compress_bound(size));
+        std::vector<std::byte> decompressed(size);
+
+        std::size_t repeated_size = 0;
+
+        for (const std::vector<std::byte>& bytes : { repeated, mixed })
+        {
+            const std::size_t compressed_size = flow::lz4_compress(bytes, compressed);
+            const std::span<const std::byte> block = std::span<const std::byte>(compressed).first(compressed_size);
+
+            expect(compressed_size > 0 && flow::lz4_decompress(block, decompressed) == size && decompressed == bytes,
+                   "lz4 round trip");
+
+            repeated_size = repeated_size == 0 ? compressed_size : repeated_size;
+        }
+
+        expect(repeated_size < size / 10, "compressing repeated bytes");
+
+        const std::size_t compressed_size = flow::lz4_compress(repeated, compressed);
+        const std::span<const std::byte> block = std::span<const std::byte>(compressed).first(compressed_size);
+
+        expect(flow::lz4_decompress(block, std::span(decompressed).first(size - 1)) == error, "decompressing into too little memory");
+        expect(flow::lz4_decompress(block.first(compressed_size - 1), decompressed) == error, "decompressing a truncated block");
+        expect(flow::lz4_compress(repeated, std::span(compressed).first(repeated_size - 1)) == 0, "compressing into too little memory");
+
+        FLOW_LOG_INFO("lz4: {} bytes of repeated bytes compressed to {}", size, repeated_size);
+    }
+
+    // a compressed stream after a prefix, read whole and after seeks into the middle of its
+    // blocks, then cut short and with a broken block
+    static void test_lz4_stream()
+    {
+        constexpr std::size_t block_size = 1000;
+        constexpr std::uint64_t prefix = 42;
+        constexpr std::size_t middle = 4321;
+
+        const std::vector<std::uint32_t> values = make_sorted_values(value_count);
+
+        std::vector<std::byte> memory(value_count * sizeof(std::uint32_t) * 2);
+        flow::memory_ostream memory_out(memory);
+        flow::ostream_view out(memory_out);
+        out.write(prefix);
+
+        flow::lz4_ostream lz4_out(out, block_size);
+        flow::ostream_view(lz4_out).write(std::span(values));
+        expect(lz4_out.close() && out, "writing a compressed stream");
+
+        const std::vector<std::byte> bytes(memory_out.written().begin(), memory_out.written().end());
+
+        flow::memory_istream memory_in{ std::span<const std::byte>(bytes) };
+        flow::lz4_istream lz4_in(memory_in);
+        expect(lz4_in.good() && lz4_in.size() == value_count * sizeof(std::uint32_t), "opening a compressed stream");
+
+        flow::istream_view in(lz4_in);
+        std::vector<std::uint32_t> read_values(value_count);
+        in.read(std::span(read_values));
+        expect(in && read_values == values, "compressed stream round trip");
+
+        // the value crosses no block, the span crosses several
+        std::uint32_t value{};
+        std::vector<std::uint32_t> read_span(block_size);
+        in.seek(static_cast<flow::istream_view::pos_type>(middle * sizeof(std::uint32_t))).read(value).read(std::span(read_span));
+        expect(in && value == values[middle] && matches(read_span, middle + 1, values), "seeking in a compressed stream");
+
+        in.seek(0, flow::istream_view::end).read(value);
+        expect(!in, "reading past the end of a compressed stream");
+
+        // the footer is at the end
+        flow::memory_istream truncated{ std::span<const std::byte>(bytes).first(bytes.size() - 1) };
+        expect(!flow::lz4_istream(truncated).good(), "opening a truncated compressed stream");
+
+        // the header of the first block claims more bytes than a block can hold
+        std::vector<std::byte> broken = bytes;
+        broken[sizeof(prefix)] = std::byte{ 0xff };
+        broken[sizeof(prefix) + 1] = std::byte{ 0xff };
+        broken[sizeof(prefix) + 2] = std::byte{ 0xff };
+
+        flow::memory_istream broken_in{ std::span<const std::byte>(broken) };
+        expect(!flow::lz4_istream(broken_in).good(), "opening a compressed stream with a broken block");
+
+        // footers that would allocate more than the stream holds, or blocks that don't add up
+        const auto forged_footer = [&](auto forge) {
+            std::vector<std::byte> forged = bytes;
+            flow::detail::lz4_stream_footer footer{};
+            std::memcpy(&footer, forged.data() + forged.size() - sizeof(footer), sizeof(footer));
+            forge(footer);
+            std::memcpy(forged.data() + forged.size() - sizeof(footer), &footer, sizeof(footer));
+
+            flow::memory_istream forged_in{ std::span<const std::byte>(forged) };
+            return flow::lz4_istream(forged_in).good();
+        };
+
+        using footer_type = flow::detail::lz4_stream_footer;
+
+        expect(!forged_footer([](footer_type& f) { f.block_count = std::numeric_limits<std::uint32_t>::max(); }),
+               "opening a compressed stream with a forged block count");
+        expect(!forged_footer([](footer_type& f) { f.block_size = flow::lz4_ostream::max_block_size + 1; }),
+               "opening a compressed stream with a forged block size");
+        expect(!forged_footer([](footer_type& f) { f.uncompressed_size += block_size; }),
+               "opening a compressed stream whose blocks don't hold its size");
+        expect(forged_footer([](footer_type&) {}), "opening a copied compressed stream");
+
+        FLOW_LOG_INFO("lz4 stream: {} bytes compressed to {}", value_count * sizeof(std::uint32_t), bytes.size() - sizeof(prefix));
+    }
+};
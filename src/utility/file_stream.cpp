@@ -0,0 +1,469 @@
+#include "../../include/flow/utility/file_stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "../../include/flow/core/assertion.hpp"
+
+#if defined(FLOW_PLATFORM_WINDOWS)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace flow {
+
+namespace {
+
+#if defined(FLOW_PLATFORM_WINDOWS)
+
+HANDLE native_handle(std::intptr_t handle) noexcept
+{
+    // NOLINTNEXTLINE(*-reinterpret-cast, *-no-int-to-ptr)
+    return reinterpret_cast<HANDLE>(handle);
+}
+
+std::intptr_t open_file(const std::filesystem::path& path, bool in, bool out, bool trunc) noexcept
+{
+    DWORD access = 0;
+    access |= in ? GENERIC_READ : 0;
+    access |= out ? GENERIC_WRITE : 0;
+
+    DWORD disposition = OPEN_EXISTING;
+    if (out)
+    {
+        disposition = trunc ? CREATE_ALWAYS : OPEN_ALWAYS;
+    }
+
+    HANDLE file = CreateFileW(path.c_str(),
+                              access,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              disposition,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    return file == INVALID_HANDLE_VALUE ? -1 : reinterpret_cast<std::intptr_t>(file);
+}
+
+void close_file(std::intptr_t handle) noexcept
+{
+    CloseHandle(native_handle(handle));
+}
+
+#else
+
+std::intptr_t open_file(const std::filesystem::path& path, bool in, bool out, bool trunc) noexcept
+{
+    int flags = O_CLOEXEC;
+    flags |= in && out ? O_RDWR : (out ? O_WRONLY : O_RDONLY);
+    flags |= out ? O_CREAT : 0;
+    flags |= out && trunc ? O_TRUNC : 0;
+
+    return ::open(path.c_str(), flags, 0644);
+}
+
+void close_file(std::intptr_t handle) noexcept
+{
+    ::close(static_cast<int>(handle));
+}
+
+#endif
+
+} // namespace
+
+bool file_stream::open(const std::filesystem::path& path, openmode mode, std::size_t buffer_size)
+{
+    FLOW_ASSERT(buffer_size > 0, "invalid buffer size");
+
+    close();
+
+    const bool in = (mode & std::ios_base::in) != 0;
+    const bool out = (mode & std::ios_base::out) != 0;
+    const bool trunc = (mode & std::ios_base::trunc) != 0;
+
+    if (!in && !out)
+    {
+        return false;
+    }
+
+    m_handle = open_file(path, in, out, trunc);
+
+    if (!is_open())
+    {
+        return false;
+    }
+
+    m_buffer.resize(buffer_size);
+    m_buffer_position = 0;
+    m_mode = buffer_mode::none;
+
+    set_get_area(nullptr, nullptr);
+    set_put_area(nullptr, nullptr);
+    istream_backend::clear();
+    ostream_backend::clear();
+
+    return true;
+}
+
+bool file_stream::close()
+{
+    if (!is_open())
+    {
+        return true;
+    }
+
+    const bool flushed = m_mode != buffer_mode::writing || flush_buffer();
+
+    close_file(m_handle);
+
+    m_handle = invalid_handle;
+    m_mode = buffer_mode::none;
+
+    set_get_area(nullptr, nullptr);
+    set_put_area(nullptr, nullptr);
+
+    return flushed;
+}
+
+std::size_t file_stream::do_read(std::span<std::byte> bytes)
+{
+    std::size_t count = 0;
+
+    if (m_mode == buffer_mode::reading)
+    {
+        count = static_cast<std::size_t>(get_end() - get_current());
+
+        if (count > 0)
+        {
+            std::memcpy(bytes.data(), get_current(), count);
+        }
+
+        set_get_area(get_end(), get_end());
+    }
+
+    if (!flush_buffer())
+    {
+        return count;
+    }
+
+    const std::span<std::byte> remaining = bytes.subspan(count);
+    const std::uint64_t offset = m_buffer_position;
+
+    if (remaining.size() >= m_buffer.size())
+    {
+        const std::size_t read = read_at(remaining, offset);
+        m_buffer_position = offset + read;
+
+        return count + read;
+    }
+
+    const std::size_t read = read_at(m_buffer, offset);
+    const std::size_t copied = std::min(read, remaining.size());
+
+    if (copied > 0)
+    {
+        std::memcpy(remaining.data(), m_buffer.data(), copied);
+    }
+
+    m_mode = buffer_mode::reading;
+    set_get_area(m_buffer.data() + copied, m_buffer.data() + read);
+
+    return count + copied;
+}
+
+bool file_stream::do_seekg(off_type offset, seekdir direction)
+{
+    return seek_to(offset, direction);
+}
+
+file_stream::pos_type file_stream::do_tellg()
+{
+    return pos_type{ static_cast<off_type>(position()) };
+}
+
+std::size_t file_stream::do_write(std::span<const std::byte> bytes)
+{
+    if (!flush_buffer())
+    {
+        return 0;
+    }
+
+    const std::uint64_t offset = m_buffer_position;
+
+    if (bytes.size() >= m_buffer.size())
+    {
+        const std::size_t written = write_at(bytes, offset);
+        m_buffer_position = offset + written;
+
+        return written;
+    }
+
+    if (!bytes.empty())
+    {
+        std::memcpy(m_buffer.data(), bytes.data(), bytes.size());
+    }
+
+    m_mode = buffer_mode::writing;
+    set_put_area(m_buffer.data() + bytes.size(), m_buffer.data() + m_buffer.size());
+
+    return bytes.size();
+}
+
+bool file_stream::do_seekp(off_type offset, seekdir direction)
+{
+    return seek_to(offset, direction);
+}
+
+file_stream::pos_type file_stream::do_tellp()
+{
+    return pos_type{ static_cast<off_type>(position()) };
+}
+
+bool file_stream::do_flush()
+{
+    return m_mode != buffer_mode::writing || flush_buffer();
+}
+
+bool file_stream::seek_to(off_type offset, seekdir direction)
+{
+    if (!is_open())
+    {
+        return false;
+    }
+
+    off_type base{};
+
+    switch (direction)
+    {
+        case std::ios_base::beg: base = 0; break;
+        case std::ios_base::cur: base = static_cast<off_type>(position()); break;
+        case std::ios_base::end:
+        {
+            std::uint64_t size{};
+
+            if ((m_mode == buffer_mode::writing && !flush_buffer()) || !file_size(size))
+            {
+                return false;
+            }
+
+            base = static_cast<off_type>(size);
+            break;
+        }
+        default: return false;
+    }
+
+    const off_type target = base + offset;
+
+    if (target < 0)
+    {
+        return false;
+    }
+
+    const auto target_position = static_cast<std::uint64_t>(target);
+
+    // seeking inside the buffered bytes only moves the get area,
+    // which keeps searches over nearby positions from hitting the os
+    if (m_mode == buffer_mode::reading && target_position >= m_buffer_position
+        && target_position <= m_buffer_position + static_cast<std::uint64_t>(get_end() - m_buffer.data()))
+    {
+        set_get_area(m_buffer.data() + (target_position - m_buffer_position), get_end());
+        return true;
+    }
+
+    if (!flush_buffer())
+    {
+        return false;
+    }
+
+    m_buffer_position = target_position;
+
+    return true;
+}
+
+bool file_stream::flush_buffer()
+{
+    bool flushed = true;
+
+    if (m_mode == buffer_mode::writing)
+    {
+        const auto pending = static_cast<std::size_t>(put_current() - m_buffer.data());
+        const std::size_t written = write_at(std::span(m_buffer).first(pending), m_buffer_position);
+
+        m_buffer_position += written;
+        flushed = written == pending;
+    }
+    else if (m_mode == buffer_mode::reading)
+    {
+        m_buffer_position = position();
+    }
+
+    m_mode = buffer_mode::none;
+    set_get_area(nullptr, nullptr);
+    set_put_area(nullptr, nullptr);
+
+    return flushed;
+}
+
+std::uint64_t file_stream::position() const noexcept
+{
+    switch (m_mode)
+    {
+        case buffer_mode::reading: return m_buffer_position + static_cast<std::uint64_t>(get_current() - m_buffer.data());
+        case buffer_mode::writing: return m_buffer_position + static_cast<std::uint64_t>(put_current() - m_buffer.data());
+        default:                   return m_buffer_position;
+    }
+}
+
+#if defined(FLOW_PLATFORM_WINDOWS)
+
+std::size_t file_stream::read_at(std::span<std::byte> bytes, std::uint64_t offset) const
+{
+    std::size_t count = 0;
+
+    while (count < bytes.size())
+    {
+        const std::uint64_t at = offset + count;
+
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(at);
+        overlapped.OffsetHigh = static_cast<DWORD>(at >> 32);
+
+        const auto size = static_cast<DWORD>(std::min<std::size_t>(bytes.size() - count, std::numeric_limits<DWORD>::max()));
+        DWORD read = 0;
+
+        if (!ReadFile(native_handle(m_handle), bytes.data() + count, size, &read, &overlapped) || read == 0)
+        {
+            break;
+        }
+
+        count += read;
+    }
+
+    return count;
+}
+
+std::size_t file_stream::write_at(std::span<const std::byte> bytes, std::uint64_t offset) const
+{
+    std::size_t count = 0;
+
+    while (count < bytes.size())
+    {
+        const std::uint64_t at = offset + count;
+
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(at);
+        overlapped.OffsetHigh = static_cast<DWORD>(at >> 32);
+
+        const auto size = static_cast<DWORD>(std::min<std::size_t>(bytes.size() - count, std::numeric_limits<DWORD>::max()));
+        DWORD written = 0;
+
+        if (!WriteFile(native_handle(m_handle), bytes.data() + count, size, &written, &overlapped) || written == 0)
+        {
+            break;
+        }
+
+        count += written;
+    }
+
+    return count;
+}
+
+bool file_stream::file_size(std::uint64_t& size) const
+{
+    LARGE_INTEGER file_size{};
+
+    if (!GetFileSizeEx(native_handle(m_handle), &file_size))
+    {
+        return false;
+    }
+
+    size = static_cast<std::uint64_t>(file_size.QuadPart);
+
+    return true;
+}
+
+#else
+
+std::size_t file_stream::read_at(std::span<std::byte> bytes, std::uint64_t offset) const
+{
+    std::size_t count = 0;
+
+    while (count < bytes.size())
+    {
+        const ::ssize_t read = ::pread(static_cast<int>(m_handle),
+                                       bytes.data() + count,
+                                       bytes.size() - count,
+                                       static_cast<::off_t>(offset + count));
+
+        if (read == -1 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (read <= 0)
+        {
+            break;
+        }
+
+        count += static_cast<std::size_t>(read);
+    }
+
+    return count;
+}
+
+std::size_t file_stream::write_at(std::span<const std::byte> bytes, std::uint64_t offset) const
+{
+    std::size_t count = 0;
+
+    while (count < bytes.size())
+    {
+        const ::ssize_t written = ::pwrite(static_cast<int>(m_handle),
+                                           bytes.data() + count,
+                                           bytes.size() - count,
+                                           static_cast<::off_t>(offset + count));
+
+        if (written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            break;
+        }
+
+        count += static_cast<std::size_t>(written);
+    }
+
+    return count;
+}
+
+bool file_stream::file_size(std::uint64_t& size) const
+{
+    struct stat file_stat{};
+
+    if (::fstat(static_cast<int>(m_handle), &file_stat) == -1)
+    {
+        return false;
+    }
+
+    size = static_cast<std::uint64_t>(file_stat.st_size);
+
+    return true;
+}
+
+#endif
+
+} // namespace flow
@@ -0,0 +1,205 @@
+#include "../../include/flow/utility/mapped_file.hpp"
+
+#include <algorithm>
+
+#if defined(FLOW_PLATFORM_WINDOWS)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <memoryapi.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace flow {
+
+#if defined(FLOW_PLATFORM_WINDOWS)
+
+bool mapped_file::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    HANDLE file = CreateFileW(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // a mapping can't be created for an empty file
+    if (file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        m_is_open = true;
+        return true;
+    }
+
+    // the view keeps the mapping alive, so both handles can be closed right away
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const std::byte*>(data);
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+    m_is_open = true;
+
+    return true;
+}
+
+void mapped_file::close() noexcept
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_is_open = false;
+}
+
+bool mapped_file::advise(std::size_t offset, std::size_t size, mapped_file_advice advice) const noexcept
+{
+    if (!m_data || offset >= m_size)
+    {
+        return false;
+    }
+
+    size = std::min(size, m_size - offset);
+
+    // only prefetching has a win32 equivalent, the access pattern hints are left to the os
+    if (advice != mapped_file_advice::will_need || size == 0)
+    {
+        return false;
+    }
+
+    WIN32_MEMORY_RANGE_ENTRY range{};
+    // NOLINTNEXTLINE(*-const-cast)
+    range.VirtualAddress = const_cast<std::byte*>(m_data + offset);
+    range.NumberOfBytes = size;
+
+    return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0) != 0;
+}
+
+#else
+
+bool mapped_file::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat file_stat{};
+    if (::fstat(fd, &file_stat) == -1 || file_stat.st_size < 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // mmap fails for a size of zero
+    if (file_stat.st_size == 0)
+    {
+        ::close(fd);
+        m_is_open = true;
+        return true;
+    }
+
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+
+    // the mapping keeps its own reference to the file, so the descriptor can be closed right away
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const std::byte*>(data);
+    m_size = size;
+    m_is_open = true;
+
+    return true;
+}
+
+void mapped_file::close() noexcept
+{
+    if (m_data)
+    {
+        // NOLINTNEXTLINE(*-const-cast)
+        ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_is_open = false;
+}
+
+bool mapped_file::advise(std::size_t offset, std::size_t size, mapped_file_advice advice) const noexcept
+{
+    if (!m_data || offset >= m_size)
+    {
+        return false;
+    }
+
+    size = std::min(size, m_size - offset);
+
+    int flag = MADV_NORMAL;
+
+    switch (advice)
+    {
+        case mapped_file_advice::normal:     flag = MADV_NORMAL; break;
+        case mapped_file_advice::sequential: flag = MADV_SEQUENTIAL; break;
+        case mapped_file_advice::random:     flag = MADV_RANDOM; break;
+        case mapped_file_advice::will_need:  flag = MADV_WILLNEED; break;
+        case mapped_file_advice::dont_need:  flag = MADV_DONTNEED; break;
+    }
+
+    // madvise expects a page aligned address, the mapping itself starts on a page boundary
+    static const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t aligned_offset = offset - offset % page_size;
+
+    // NOLINTNEXTLINE(*-const-cast)
+    return ::madvise(const_cast<std::byte*>(m_data + aligned_offset), size + (offset - aligned_offset), flag) == 0;
+}
+
+#endif
+
+} // namespace flow
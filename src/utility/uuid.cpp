@@ -1,11 +1,23 @@
 #include "../../include/flow/utility/uuid.hpp"
 
+#include <mutex>
+
 #include "../../include/flow/utility/random.hpp"
 
 namespace flow {
 
 namespace {
-    random_generator generator(std::random_device{}());
+    // every thread takes its own stream once, instead of sharing a single generator
+    random_generator make_thread_generator()
+    {
+        static std::mutex mutex{};
+        static random_stream_factory factory(std::random_device{}());
+
+        std::lock_guard lock{ mutex };
+        return factory.next();
+    }
+
+    thread_local random_generator generator = make_thread_generator();
 }
 
 uuid uuid::generate()